@@ -19,8 +19,8 @@
 
 #include <thread>
 #include <memory>
-#include <map>
 #include <mutex>
+#include <unordered_map>
 
 namespace eprosima{
 namespace uxr{
@@ -28,6 +28,9 @@ namespace uxr{
 class Root
 {
 public:
+    /* Clients indexed by their raw client key. */
+    typedef std::unordered_map<uint32_t, std::shared_ptr<ProxyClient>> ClientMap;
+
     Root();
     ~Root();
 
@@ -47,18 +50,34 @@ public:
 
     std::shared_ptr<ProxyClient> get_client(const dds::xrce::ClientKey& client_key);
 
-    bool get_next_client(std::shared_ptr<ProxyClient>& next_client);
+    std::shared_ptr<ProxyClient> get_client(uint32_t raw_client_key);
+
+    /* Snapshot of the clients, it is not affected by later creations nor deletions. */
+    std::shared_ptr<const ClientMap> get_clients() const;
 
     bool load_config_file(const std::string& file_path);
 
     void set_verbose_level(uint8_t verbose_level);
 
+    /* Depths given to the streams of the clients which do not request other ones. */
+    bool set_stream_depths(const StreamDepths& stream_depths);
+
     void reset();
 
 private:
+    /* Copy of the current clients to be modified and published by a writer holding mtx_. */
+    std::shared_ptr<ClientMap> copy_clients() const;
+
+    void publish_clients(std::shared_ptr<ClientMap>&& clients);
+
+private:
+    /**
+     * Serializes writers. Readers never take it, they load a snapshot of clients_ with std::atomic_load,
+     * which only holds the short internal lock the standard library keeps for shared_ptr atomics.
+     */
     std::mutex mtx_;
-    std::map<dds::xrce::ClientKey, std::shared_ptr<ProxyClient>> clients_;
-    std::map<dds::xrce::ClientKey, std::shared_ptr<ProxyClient>>::iterator current_client_;
+    std::shared_ptr<const ClientMap> clients_;
+    StreamDepths stream_depths_;
 };
 
 } // uxr
@@ -18,18 +18,25 @@
 #include <uxr/agent/middleware/Middleware.hpp>
 #include <uxr/agent/participant/Participant.hpp>
 #include <uxr/agent/client/session/Session.hpp>
+#include <uxr/agent/object/ObjectTable.hpp>
 #include <unordered_map>
 #include <array>
+#include <memory>
 
 namespace eprosima {
 namespace uxr {
 
+class EndPoint;
+class DataWriter;
+class DataReader;
+
 class ProxyClient
 {
 public:
     explicit ProxyClient(
             const dds::xrce::CLIENT_Representation& representation,
-            Middleware::Kind middleware_kind = Middleware::Kind(0));
+            Middleware::Kind middleware_kind = Middleware::Kind(0),
+            const StreamDepths& stream_depths = StreamDepths{BEST_EFFORT_STREAM_DEPTH, RELIABLE_STREAM_DEPTH});
 
     ~ProxyClient() = default;
 
@@ -54,12 +61,24 @@ public:
 
     std::shared_ptr<XRCEObject> get_object(const dds::xrce::ObjectId& object_id);
 
+    /* Typed lookups of the data path, they do not take the client lock. */
+    std::shared_ptr<DataWriter> get_datawriter(const dds::xrce::ObjectId& object_id) const;
+
+    std::shared_ptr<DataReader> get_datareader(const dds::xrce::ObjectId& object_id) const;
+
     const dds::xrce::ClientKey& get_client_key() const { return representation_.client_key(); }
 
     dds::xrce::SessionId get_session_id() const { return representation_.session_id(); }
 
+    StreamDepths get_stream_depths() const { return session_.get_stream_depths(); }
+
     Session& session();
 
+    /* Endpoint the client is reached at, replaced as a whole when its address changes. */
+    std::shared_ptr<EndPoint> get_source() const { return std::atomic_load(&source_); }
+
+    void set_source(const std::shared_ptr<EndPoint>& source) { std::atomic_store(&source_, source); }
+
 private:
     bool create_object(
             const dds::xrce::ObjectId& object_id,
@@ -99,12 +118,18 @@ private:
     bool delete_object_unlock(
             const dds::xrce::ObjectId& object_id);
 
+    /* Drops the writers and readers released along with their parents. */
+    void prune_object_tables();
+
 private:
     const dds::xrce::CLIENT_Representation representation_;
     std::unique_ptr<Middleware> middleware_;
     std::mutex mtx_;
     XRCEObject::ObjectContainer objects_;
+    ObjectTable<DataWriter> datawriters_;
+    ObjectTable<DataReader> datareaders_;
     Session session_;
+    std::shared_ptr<EndPoint> source_;
 };
 
 } // namespace uxr
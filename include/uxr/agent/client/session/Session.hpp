@@ -19,7 +19,8 @@
 #include <uxr/agent/client/session/stream/InputStream.hpp>
 #include <uxr/agent/client/session/stream/OutputStream.hpp>
 
-#include <unordered_map>
+#include <array>
+#include <atomic>
 #include <memory>
 
 namespace eprosima {
@@ -40,12 +41,100 @@ inline bool is_reliable_stream(dds::xrce::StreamId stream_id)
     return (dds::xrce::STREAMID_BUILTIN_RELIABLE <= stream_id);
 }
 
+/**
+ * Streams of one kind indexed by the low 7 bits of their id, best-effort ids run from 1 to 127 and
+ * reliable ones from 128 to 255. A stream is created on first use and lives as long as the session,
+ * so looking it up takes no lock, each stream serializes its own operations.
+ */
+template<class T>
+class StreamTable
+{
+public:
+    explicit StreamTable(
+            uint16_t depth)
+        : depth_(depth)
+    {
+        for (auto& stream : streams_)
+        {
+            stream.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~StreamTable()
+    {
+        for (auto& stream : streams_)
+        {
+            delete stream.load(std::memory_order_relaxed);
+        }
+    }
+
+    StreamTable(StreamTable&&) = delete;
+    StreamTable(const StreamTable&) = delete;
+    StreamTable& operator=(StreamTable&&) = delete;
+    StreamTable& operator=(const StreamTable&) = delete;
+
+    T& get(dds::xrce::StreamId stream_id);
+
+    /* Visits the streams created so far with their id. */
+    template<class F>
+    void for_each(
+            dds::xrce::StreamId first_id,
+            F&& function);
+
+private:
+    static constexpr size_t max_streams_ = 128;
+
+    const uint16_t depth_;
+    std::array<std::atomic<T*>, max_streams_> streams_;
+};
+
+template<class T>
+inline T& StreamTable<T>::get(dds::xrce::StreamId stream_id)
+{
+    std::atomic<T*>& entry = streams_[stream_id & (max_streams_ - 1)];
+    T* stream = entry.load(std::memory_order_acquire);
+    if (nullptr == stream)
+    {
+        /* Concurrent first uses race to install their stream, the losers drop theirs. */
+        std::unique_ptr<T> created(new T(depth_));
+        if (entry.compare_exchange_strong(stream, created.get(), std::memory_order_acq_rel))
+        {
+            stream = created.release();
+        }
+    }
+    return *stream;
+}
+
+template<class T>
+template<class F>
+inline void StreamTable<T>::for_each(
+        dds::xrce::StreamId first_id,
+        F&& function)
+{
+    for (size_t i = 0; i < max_streams_; ++i)
+    {
+        T* stream = streams_[i].load(std::memory_order_acquire);
+        if (nullptr != stream)
+        {
+            function(dds::xrce::StreamId(first_id + i), *stream);
+        }
+    }
+}
+
 class Session
 {
 public:
-    Session(const SessionInfo& info)
+    Session(
+            const SessionInfo& info,
+            const StreamDepths& depths = StreamDepths{BEST_EFFORT_STREAM_DEPTH, RELIABLE_STREAM_DEPTH})
         : session_info_{info}
-        , none_ostream_{}
+        , depths_{depths}
+        , none_istream_{depths.best_effort}
+        , best_effort_istreams_{depths.best_effort}
+        , reliable_istreams_{depths.reliable}
+        , none_ostream_{depths.best_effort}
+        , best_effort_ostreams_{depths.best_effort}
+        , reliable_ostreams_{depths.reliable}
     {}
 
     ~Session() = default;
@@ -57,6 +146,10 @@ public:
 
     void reset();
 
+    const StreamDepths& get_stream_depths() const { return depths_; }
+
+    size_t get_mtu() const { return session_info_.mtu; }
+
     /* Input streams functions. */
     bool push_input_message(
             InputMessagePtr&& message,
@@ -87,15 +180,33 @@ public:
     /* Output streams functions. */
     std::vector<uint8_t> get_output_streams();
 
+    /* Coalescing and flushing only apply to the best-effort and reliable streams. */
     template<class T>
     void push_output_submessage(
             dds::xrce::StreamId stream_id,
             dds::xrce::SubmessageId submessage_id,
-            const T& submessage);
+            const T& submessage,
+            bool coalesce = false);
 
     bool get_next_output_message(
             dds::xrce::StreamId stream_id,
-            OutputMessagePtr& output_message);
+            OutputMessagePtr& output_message,
+            bool flush = true);
+
+    bool arm_flush(
+            dds::xrce::StreamId stream_id,
+            SeqNum& seq_num);
+
+    bool is_flush_armed(
+            dds::xrce::StreamId stream_id,
+            SeqNum seq_num);
+
+    void set_flush_timer(
+            dds::xrce::StreamId stream_id,
+            uint64_t timer_id);
+
+    uint64_t get_flush_timer(
+            dds::xrce::StreamId stream_id);
 
     bool get_output_message(
             dds::xrce::StreamId stream_id,
@@ -110,53 +221,63 @@ public:
             dds::xrce::StreamId stream_id,
             dds::xrce::HEARTBEAT_Payload& heartbeat);
 
-private:
-    const SessionInfo session_info_;
+    bool arm_heartbeat(
+            dds::xrce::StreamId stream_id);
 
-    NoneInputStream none_istream_;
-    std::unordered_map<dds::xrce::StreamId, BestEffortInputStream> best_effort_istreams_;
-    std::unordered_map<dds::xrce::StreamId, ReliableInputStream> reliable_istreams_;
-    std::mutex best_effort_imtx_;
-    std::mutex reliable_imtx_;
+    bool rearm_heartbeat(
+            dds::xrce::StreamId stream_id);
 
-    NoneOutputStream none_ostream_;
-    std::unordered_map<dds::xrce::StreamId, BestEffortOutputStream> best_effort_ostreams_;
-    std::unordered_map<dds::xrce::StreamId, ReliableOutputStream> reliable_ostreams_;
-    std::mutex best_effort_omtx_;
-    std::mutex reliable_omtx_;
-};
+    std::chrono::milliseconds get_heartbeat_period(
+            dds::xrce::StreamId stream_id);
 
-inline void Session::reset()
-{
-    std::unique_lock<std::mutex> best_effort_ilock(best_effort_imtx_);
-    for (auto& it : best_effort_istreams_)
+    void set_heartbeat_timer(
+            dds::xrce::StreamId stream_id,
+            uint64_t timer_id);
+
+    uint64_t get_heartbeat_timer(
+            dds::xrce::StreamId stream_id);
+
+private:
+    BestEffortInputStream& best_effort_istream(dds::xrce::StreamId stream_id)
     {
-        it.second.reset();
+        return best_effort_istreams_.get(stream_id);
     }
-    best_effort_ilock.unlock();
 
-    std::unique_lock<std::mutex> reliable_ilock(reliable_imtx_);
-    for (auto& it : reliable_istreams_)
+    ReliableInputStream& reliable_istream(dds::xrce::StreamId stream_id)
     {
-        it.second.reset();
+        return reliable_istreams_.get(stream_id);
     }
-    reliable_ilock.unlock();
-
-    none_ostream_.reset();
 
-    std::unique_lock<std::mutex> best_effort_olock(best_effort_omtx_);
-    for (auto& it : best_effort_ostreams_)
+    BestEffortOutputStream& best_effort_ostream(dds::xrce::StreamId stream_id)
     {
-        it.second.reset();
+        return best_effort_ostreams_.get(stream_id);
     }
-    best_effort_olock.unlock();
 
-    std::unique_lock<std::mutex> reliable_olock(reliable_omtx_);
-    for (auto& it : reliable_ostreams_)
+    ReliableOutputStream& reliable_ostream(dds::xrce::StreamId stream_id)
     {
-        it.second.reset();
+        return reliable_ostreams_.get(stream_id);
     }
-    reliable_olock.unlock();
+
+private:
+    const SessionInfo session_info_;
+    const StreamDepths depths_;
+
+    NoneInputStream none_istream_;
+    StreamTable<BestEffortInputStream> best_effort_istreams_;
+    StreamTable<ReliableInputStream> reliable_istreams_;
+
+    NoneOutputStream none_ostream_;
+    StreamTable<BestEffortOutputStream> best_effort_ostreams_;
+    StreamTable<ReliableOutputStream> reliable_ostreams_;
+};
+
+inline void Session::reset()
+{
+    best_effort_istreams_.for_each(0, [](dds::xrce::StreamId, BestEffortInputStream& stream) { stream.reset(); });
+    reliable_istreams_.for_each(0, [](dds::xrce::StreamId, ReliableInputStream& stream) { stream.reset(); });
+    none_ostream_.reset();
+    best_effort_ostreams_.for_each(0, [](dds::xrce::StreamId, BestEffortOutputStream& stream) { stream.reset(); });
+    reliable_ostreams_.for_each(0, [](dds::xrce::StreamId, ReliableOutputStream& stream) { stream.reset(); });
 }
 
 /**************************************************************************************************
@@ -175,13 +296,11 @@ inline bool Session::push_input_message(
     }
     else if (is_besteffort_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(best_effort_imtx_);
-        rv = best_effort_istreams_[stream_id].push_message(sequence_nr, std::move(message));
+        rv = best_effort_istream(stream_id).push_message(sequence_nr, std::move(message));
     }
     else
     {
-        std::lock_guard<std::mutex> lock(reliable_imtx_);
-        rv = reliable_istreams_[stream_id].push_message(sequence_nr, std::move(message));
+        rv = reliable_istream(stream_id).push_message(sequence_nr, std::move(message));
     }
     return rv;
 }
@@ -197,13 +316,11 @@ inline bool Session::pop_input_message(
     }
     else if (is_besteffort_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(best_effort_imtx_);
-        rv = best_effort_istreams_[stream_id].pop_message(message);
+        rv = best_effort_istream(stream_id).pop_message(message);
     }
     else
     {
-        std::lock_guard<std::mutex> lock(reliable_imtx_);
-        rv = reliable_istreams_[stream_id].pop_message(message);
+        rv = reliable_istream(stream_id).pop_message(message);
     }
     return rv;
 }
@@ -215,8 +332,7 @@ inline void Session::update_from_heartbeat(
 {
     if (is_reliable_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(reliable_imtx_);
-        reliable_istreams_[stream_id].update_from_heartbeat(first_unacked, last_unacked);
+        reliable_istream(stream_id).update_from_heartbeat(first_unacked, last_unacked);
     }
 }
 
@@ -226,8 +342,7 @@ inline void Session::fill_acknack(
 {
     if (is_reliable_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(reliable_imtx_);
-        reliable_istreams_[stream_id].fill_acknack(acknack);
+        reliable_istream(stream_id).fill_acknack(acknack);
     }
 }
 
@@ -235,15 +350,18 @@ inline void Session::push_input_fragment(dds::xrce::StreamId stream_id, InputMes
 {
     if (is_reliable_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(reliable_imtx_);
-        reliable_istreams_[stream_id].push_fragment(message);
+        reliable_istream(stream_id).push_fragment(session_info_, message);
     }
 }
 
 inline bool Session::pop_input_fragment_message(dds::xrce::StreamId stream_id, InputMessagePtr& message)
 {
-    std::lock_guard<std::mutex> lock(reliable_imtx_);
-    return reliable_istreams_[stream_id].pop_fragment_message(message);
+    bool rv = false;
+    if (is_reliable_stream(stream_id))
+    {
+        rv = reliable_istream(stream_id).pop_fragment_message(message);
+    }
+    return rv;
 }
 
 /**************************************************************************************************
@@ -252,12 +370,12 @@ inline bool Session::pop_input_fragment_message(dds::xrce::StreamId stream_id, I
 
 inline std::vector<uint8_t> Session::get_output_streams()
 {
-    std::lock_guard<std::mutex> lock(reliable_omtx_);
-    std::vector<uint8_t> result(reliable_ostreams_.size());
-    for (auto it = reliable_ostreams_.begin(); it != reliable_ostreams_.end(); ++it)
-    {
-        result.push_back(it->first);
-    }
+    std::vector<uint8_t> result;
+    reliable_ostreams_.for_each(dds::xrce::STREAMID_BUILTIN_RELIABLE,
+                                [&result](dds::xrce::StreamId stream_id, ReliableOutputStream&)
+                                {
+                                    result.push_back(stream_id);
+                                });
     return result;
 }
 
@@ -265,7 +383,8 @@ template<class T>
 inline void Session::push_output_submessage(
         dds::xrce::StreamId stream_id,
         dds::xrce::SubmessageId submessage_id,
-        const T& submessage)
+        const T& submessage,
+        bool coalesce)
 {
     if (is_none_stream(stream_id))
     {
@@ -273,19 +392,18 @@ inline void Session::push_output_submessage(
     }
     else if (is_besteffort_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(best_effort_omtx_);
-        best_effort_ostreams_[stream_id].push_submessage(session_info_, stream_id, submessage_id, submessage);
+        best_effort_ostream(stream_id).push_submessage(session_info_, stream_id, submessage_id, submessage, coalesce);
     }
     else
     {
-        std::lock_guard<std::mutex> lock(reliable_omtx_);
-        reliable_ostreams_[stream_id].push_submessage(session_info_, stream_id, submessage_id, submessage);
+        reliable_ostream(stream_id).push_submessage(session_info_, stream_id, submessage_id, submessage, coalesce);
     }
 }
 
 inline bool Session::get_next_output_message(
         dds::xrce::StreamId stream_id,
-        OutputMessagePtr& output_message)
+        OutputMessagePtr& output_message,
+        bool flush)
 {
     bool rv = false;
     if (is_none_stream(stream_id))
@@ -294,13 +412,72 @@ inline bool Session::get_next_output_message(
     }
     else if (is_besteffort_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(best_effort_omtx_);
-        rv = best_effort_ostreams_[stream_id].pop_message(output_message);
+        rv = best_effort_ostream(stream_id).pop_message(output_message, flush);
     }
     else
     {
-        std::lock_guard<std::mutex> lock(reliable_omtx_);
-        rv = reliable_ostreams_[stream_id].get_next_message(output_message);
+        rv = reliable_ostream(stream_id).get_next_message(output_message, flush);
+    }
+    return rv;
+}
+
+inline bool Session::arm_flush(
+        dds::xrce::StreamId stream_id,
+        SeqNum& seq_num)
+{
+    bool rv = false;
+    if (is_besteffort_stream(stream_id))
+    {
+        rv = best_effort_ostream(stream_id).arm_flush(seq_num);
+    }
+    else if (is_reliable_stream(stream_id))
+    {
+        rv = reliable_ostream(stream_id).arm_flush(seq_num);
+    }
+    return rv;
+}
+
+inline bool Session::is_flush_armed(
+        dds::xrce::StreamId stream_id,
+        SeqNum seq_num)
+{
+    bool rv = false;
+    if (is_besteffort_stream(stream_id))
+    {
+        rv = best_effort_ostream(stream_id).is_flush_armed(seq_num);
+    }
+    else if (is_reliable_stream(stream_id))
+    {
+        rv = reliable_ostream(stream_id).is_flush_armed(seq_num);
+    }
+    return rv;
+}
+
+inline void Session::set_flush_timer(
+        dds::xrce::StreamId stream_id,
+        uint64_t timer_id)
+{
+    if (is_besteffort_stream(stream_id))
+    {
+        best_effort_ostream(stream_id).set_flush_timer(timer_id);
+    }
+    else if (is_reliable_stream(stream_id))
+    {
+        reliable_ostream(stream_id).set_flush_timer(timer_id);
+    }
+}
+
+inline uint64_t Session::get_flush_timer(
+        dds::xrce::StreamId stream_id)
+{
+    uint64_t rv = 0;
+    if (is_besteffort_stream(stream_id))
+    {
+        rv = best_effort_ostream(stream_id).get_flush_timer();
+    }
+    else if (is_reliable_stream(stream_id))
+    {
+        rv = reliable_ostream(stream_id).get_flush_timer();
     }
     return rv;
 }
@@ -313,8 +490,7 @@ inline bool Session::get_output_message(
     bool rv = false;
     if (is_reliable_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(reliable_omtx_);
-        rv = reliable_ostreams_[stream_id].get_message(seq_num, output_message);
+        rv = reliable_ostream(stream_id).get_message(seq_num, output_message);
     }
     return rv;
 }
@@ -325,8 +501,7 @@ inline void Session::update_from_acknack(
 {
     if (is_reliable_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(reliable_omtx_);
-        reliable_ostreams_[stream_id].update_from_acknack(first_unacked);
+        reliable_ostream(stream_id).update_from_acknack(first_unacked);
     }
 }
 
@@ -338,13 +513,66 @@ inline bool Session::fill_heartbeat(
     bool rv = false;
     if (is_reliable_stream(stream_id))
     {
-        std::lock_guard<std::mutex> lock(reliable_omtx_);
-        rv = reliable_ostreams_[stream_id].fill_heartbeat(heartbeat);
+        rv = reliable_ostream(stream_id).fill_heartbeat(heartbeat);
         heartbeat.stream_id(stream_id);
     }
     return rv;
 }
 
+inline bool Session::arm_heartbeat(
+        dds::xrce::StreamId stream_id)
+{
+    bool rv = false;
+    if (is_reliable_stream(stream_id))
+    {
+        rv = reliable_ostream(stream_id).arm_heartbeat();
+    }
+    return rv;
+}
+
+inline bool Session::rearm_heartbeat(
+        dds::xrce::StreamId stream_id)
+{
+    bool rv = false;
+    if (is_reliable_stream(stream_id))
+    {
+        rv = reliable_ostream(stream_id).rearm_heartbeat();
+    }
+    return rv;
+}
+
+inline std::chrono::milliseconds Session::get_heartbeat_period(
+        dds::xrce::StreamId stream_id)
+{
+    std::chrono::milliseconds rv(HEARTBEAT_PERIOD);
+    if (is_reliable_stream(stream_id))
+    {
+        rv = reliable_ostream(stream_id).get_heartbeat_period();
+    }
+    return rv;
+}
+
+inline void Session::set_heartbeat_timer(
+        dds::xrce::StreamId stream_id,
+        uint64_t timer_id)
+{
+    if (is_reliable_stream(stream_id))
+    {
+        reliable_ostream(stream_id).set_heartbeat_timer(timer_id);
+    }
+}
+
+inline uint64_t Session::get_heartbeat_timer(
+        dds::xrce::StreamId stream_id)
+{
+    uint64_t rv = 0;
+    if (is_reliable_stream(stream_id))
+    {
+        rv = reliable_ostream(stream_id).get_heartbeat_timer();
+    }
+    return rv;
+}
+
 
 } // namespace uxr
 } // namespace eprosima
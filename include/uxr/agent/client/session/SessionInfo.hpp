@@ -15,6 +15,7 @@
 #ifndef UXR_AGENT_CLIENT_SESSION_SESSION_INFO_HPP_
 #define UXR_AGENT_CLIENT_SESSION_SESSION_INFO_HPP_
 
+#include <uxr/agent/config.hpp>
 #include <uxr/agent/types/XRCETypes.hpp>
 
 namespace eprosima {
@@ -27,6 +28,26 @@ struct SessionInfo
     size_t mtu;
 };
 
+/* CREATE_CLIENT properties through which a client requests the depth of its streams. */
+const char* const BEST_EFFORT_DEPTH_PROPERTY = "uxr.best_effort_depth";
+const char* const RELIABLE_DEPTH_PROPERTY = "uxr.reliable_depth";
+
+struct StreamDepths
+{
+    uint16_t best_effort;
+    uint16_t reliable;
+};
+
+inline bool operator==(const StreamDepths& lhs, const StreamDepths& rhs)
+{
+    return (lhs.best_effort == rhs.best_effort) && (lhs.reliable == rhs.reliable);
+}
+
+inline bool operator!=(const StreamDepths& lhs, const StreamDepths& rhs)
+{
+    return !(lhs == rhs);
+}
+
 } // namespace uxr
 } // namespace eprosima
 
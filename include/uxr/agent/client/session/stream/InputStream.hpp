@@ -20,9 +20,11 @@
 #include <uxr/agent/utils/SeqNum.hpp>
 #include <uxr/agent/client/session/SessionInfo.hpp>
 
-#include <map>
+#include <algorithm>
+#include <cstring>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
@@ -33,7 +35,10 @@ namespace uxr {
 class NoneInputStream
 {
 public:
-    NoneInputStream() = default;
+    explicit NoneInputStream(
+            size_t depth = BEST_EFFORT_STREAM_DEPTH)
+        : depth_(depth)
+    {}
 
     bool push_message(
             InputMessagePtr&& input_message);
@@ -49,6 +54,7 @@ public:
 
 private:
     std::queue<InputMessagePtr> messages_;
+    size_t depth_;
     std::mutex mtx_;
 };
 
@@ -57,7 +63,7 @@ inline bool NoneInputStream::push_message(
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if (messages_.size() < BEST_EFFORT_STREAM_DEPTH)
+    if (messages_.size() < depth_)
     {
         messages_.push(std::move(input_message));
         rv = true;
@@ -71,7 +77,7 @@ inline bool NoneInputStream::emplace_message(
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if (messages_.size() < BEST_EFFORT_STREAM_DEPTH)
+    if (messages_.size() < depth_)
     {
         messages_.emplace(new InputMessage(std::forward<Args>(args)...));
         rv = true;
@@ -107,8 +113,10 @@ inline void NoneInputStream::reset()
 class BestEffortInputStream
 {
 public:
-    BestEffortInputStream()
+    explicit BestEffortInputStream(
+            size_t depth = BEST_EFFORT_STREAM_DEPTH)
         : last_received_(UINT16_MAX)
+        , depth_(depth)
     {}
 
     ~BestEffortInputStream() = default;
@@ -134,6 +142,7 @@ public:
 private:
     std::queue<InputMessagePtr> messages_;
     SeqNum last_received_;
+    size_t depth_;
     std::mutex mtx_;
 };
 
@@ -143,7 +152,7 @@ inline bool BestEffortInputStream::push_message(
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if ((seq_num > last_received_) && (messages_.size() < BEST_EFFORT_STREAM_DEPTH))
+    if ((seq_num > last_received_) && (messages_.size() < depth_))
     {
         messages_.push(std::move(input_message));
         last_received_ = seq_num;
@@ -159,7 +168,7 @@ inline bool BestEffortInputStream::emplace_message(
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if ((seq_num > last_received_) && (messages_.size() < BEST_EFFORT_STREAM_DEPTH))
+    if ((seq_num > last_received_) && (messages_.size() < depth_))
     {
         messages_.emplace(new InputMessage(std::forward<Args>(args)...));
         last_received_ = seq_num;
@@ -197,10 +206,16 @@ inline void BestEffortInputStream::reset()
 class ReliableInputStream
 {
 public:
-    ReliableInputStream()
+    explicit ReliableInputStream(
+            size_t depth = RELIABLE_STREAM_DEPTH)
         : last_handled_(UINT16_MAX),
           last_announced_(UINT16_MAX),
-          fragment_msg_{},
+          depth_(depth),
+          slots_(ring_capacity(depth)),
+          mask_(slots_.size() - 1),
+          fragment_buffer_{},
+          fragment_len_(0),
+          fragment_hint_(0),
           fragment_message_available_(false)
     {}
 
@@ -228,44 +243,90 @@ public:
 
     void fill_acknack(dds::xrce::ACKNACK_Payload& acknack);
 
-    void push_fragment(InputMessagePtr& message);
+    void push_fragment(
+            const SessionInfo& session_info,
+            InputMessagePtr& message);
 
     bool pop_fragment_message(InputMessagePtr& message);
 
     void reset();
 
+private:
+    /* Received message waiting for the previous ones, tagged with its sequence number. */
+    struct Slot
+    {
+        SeqNum seq_num;
+        InputMessagePtr message;
+    };
+
+    static size_t ring_capacity(size_t depth);
+
+    Slot& slot(SeqNum seq_num) { return slots_[uint16_t(seq_num) & mask_]; }
+
+    bool is_received(SeqNum seq_num) { return slot(seq_num).message && (slot(seq_num).seq_num == seq_num); }
+
+    bool is_acceptable(SeqNum seq_num);
+
+    void store(
+            SeqNum seq_num,
+            InputMessagePtr&& message);
+
+    void reserve_fragment(size_t len);
+
 private:
     SeqNum last_handled_;
     SeqNum last_announced_;
-    std::map<uint16_t, InputMessagePtr> messages_;
-    std::vector<uint8_t> fragment_msg_;
+    size_t depth_;
+    std::vector<Slot> slots_;
+    size_t mask_;
+    PooledBuffer fragment_buffer_;
+    size_t fragment_len_;
+    size_t fragment_hint_;
     bool fragment_message_available_;
     std::mutex mtx_;
 };
 
+/* Smallest power of two holding depth messages, so that the modulo survives the sequence number wraparound. */
+inline size_t ReliableInputStream::ring_capacity(size_t depth)
+{
+    size_t rv = 1;
+    while (rv < depth)
+    {
+        rv <<= 1;
+    }
+    return rv;
+}
+
+inline bool ReliableInputStream::is_acceptable(SeqNum seq_num)
+{
+    return (seq_num > last_handled_) &&
+           (seq_num <= last_handled_ + SeqNum(uint16_t(depth_))) &&
+           !is_received(seq_num);
+}
+
+inline void ReliableInputStream::store(
+        SeqNum seq_num,
+        InputMessagePtr&& message)
+{
+    if (seq_num > last_announced_)
+    {
+        last_announced_ = seq_num;
+    }
+    Slot& entry = slot(seq_num);
+    entry.seq_num = seq_num;
+    entry.message = std::move(message);
+}
+
 inline bool ReliableInputStream::push_message(
         SeqNum seq_num,
         InputMessagePtr&& message)
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if ((seq_num > last_handled_) && (seq_num <= last_handled_ + SeqNum(RELIABLE_STREAM_DEPTH)))
+    if (is_acceptable(seq_num))
     {
-        if (seq_num > last_announced_)
-        {
-            last_announced_ = seq_num;
-            messages_.emplace(seq_num, std::move(message));
-            rv = true;
-        }
-        else
-        {
-            auto it = messages_.find(seq_num);
-            if (it == messages_.end())
-            {
-                messages_.emplace(seq_num, std::move(message));
-                rv = true;
-            }
-        }
+        store(seq_num, std::move(message));
+        rv = true;
     }
     return rv;
 }
@@ -274,12 +335,10 @@ inline bool ReliableInputStream::pop_message(InputMessagePtr& message)
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    auto it = messages_.find(last_handled_ + 1);
-    if (it != messages_.end())
+    if (is_received(last_handled_ + 1))
     {
         last_handled_ += 1;
-        message = std::move(messages_.at(last_handled_));
-        messages_.erase(last_handled_);
+        message = std::move(slot(last_handled_).message);
         rv = true;
     }
     return rv;
@@ -292,26 +351,10 @@ inline bool ReliableInputStream::emplace_message(
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if ((seq_num > last_handled_) && (seq_num <= last_handled_ + SeqNum(RELIABLE_STREAM_DEPTH)))
+    if (is_acceptable(seq_num))
     {
-        if (seq_num > last_announced_)
-        {
-            last_announced_ = seq_num;
-            // gcc5 doesn't not support raw pointer as argument in std::pair when std::unique_ptr is create.
-            messages_.emplace(seq_num,
-                              std::unique_ptr<InputMessage>(new InputMessage(std::forward<Args>(args)...)));
-            rv = true;
-        }
-        else
-        {
-            auto it = messages_.find(seq_num);
-            if (it == messages_.end())
-            {
-                messages_.emplace(seq_num,
-                                  std::unique_ptr<InputMessage>(new InputMessage(std::forward<Args>(args)...)));
-                rv = true;
-            }
-        }
+        store(seq_num, InputMessagePtr(new InputMessage(std::forward<Args>(args)...)));
+        rv = true;
     }
     return rv;
 }
@@ -323,6 +366,12 @@ inline void ReliableInputStream::update_from_heartbeat(
     std::lock_guard<std::mutex> lock(mtx_);
     if (last_handled_ + 1 < first_unacked)
     {
+        /* Messages the client no longer keeps are released, they will never be handled. */
+        for (size_t i = 0; (i < slots_.size()) && (last_handled_ + 1 < first_unacked); ++i)
+        {
+            last_handled_ += 1;
+            slot(last_handled_).message.reset();
+        }
         last_handled_ = first_unacked - 1;
     }
     if (last_announced_ < last_unacked)
@@ -338,21 +387,13 @@ inline void ReliableInputStream::fill_acknack(dds::xrce::ACKNACK_Payload& acknac
     acknack.first_unacked_seq_num(last_handled_ + 1);
     for (uint16_t i = 0; i < 8; i++)
     {
-        if (last_handled_ + SeqNum(i) < last_announced_)
+        if ((last_handled_ + SeqNum(i) < last_announced_) && !is_received(last_handled_ + SeqNum(i + 1)))
         {
-            auto it = messages_.find(last_handled_ + SeqNum(i + 1));
-            if (it == messages_.end())
-            {
-                acknack.nack_bitmap().at(1) = acknack.nack_bitmap().at(1) | (0x01 << i);
-            }
+            acknack.nack_bitmap().at(1) = acknack.nack_bitmap().at(1) | (0x01 << i);
         }
-        if (last_handled_ + SeqNum(i + 8) < last_announced_)
+        if ((last_handled_ + SeqNum(i + 8) < last_announced_) && !is_received(last_handled_ + SeqNum(i + 9)))
         {
-            auto it = messages_.find(last_handled_ + SeqNum(i + 9));
-            if (it == messages_.end())
-            {
-                acknack.nack_bitmap().at(0) = acknack.nack_bitmap().at(0) | (0x01 << i);
-            }
+            acknack.nack_bitmap().at(0) = acknack.nack_bitmap().at(0) | (0x01 << i);
         }
     }
 }
@@ -362,26 +403,56 @@ inline void ReliableInputStream::reset()
     std::lock_guard<std::mutex> lock(mtx_);
     last_handled_ = UINT16_MAX;
     last_announced_ = UINT16_MAX;
-    messages_.clear();
+    for (auto& entry : slots_)
+    {
+        entry.message.reset();
+    }
+    fragment_buffer_.reset();
+    fragment_len_ = 0;
+    fragment_message_available_ = false;
 }
 
-inline void ReliableInputStream::push_fragment(InputMessagePtr& message)
+/* Makes room for len bytes of the message under reassembly, at least doubling the buffer to grow it. */
+inline void ReliableInputStream::reserve_fragment(size_t len)
+{
+    if (fragment_buffer_.size() < len)
+    {
+        PooledBuffer buffer = InputMessage::acquire_buffer(std::max(len, 2 * fragment_buffer_.size()));
+        if (0 != fragment_len_)
+        {
+            memcpy(buffer.get(), fragment_buffer_.get(), fragment_len_);
+        }
+        fragment_buffer_ = std::move(buffer);
+    }
+}
+
+inline void ReliableInputStream::push_fragment(
+        const SessionInfo& session_info,
+        InputMessagePtr& message)
 {
     std::lock_guard<std::mutex> lock(mtx_);
+    const size_t fragment_size = message->get_subheader().submessage_length();
 
-    /* Add header in case. */
-    if (fragment_msg_.empty())
+    /*
+     * Add header in case, sized as the previous message since fragments do not tell the total length,
+     * up to the largest message the client can fragment, a whole history of MTU-sized messages.
+     */
+    if (0 == fragment_len_)
     {
         std::array<uint8_t, 8> raw_header;
         uint8_t header_size = message->get_raw_header(raw_header);
-        fragment_msg_.insert(fragment_msg_.begin(), std::begin(raw_header), std::begin(raw_header) + header_size);
+        const size_t max_message_size = depth_ * session_info.mtu;
+        reserve_fragment(std::max(std::min(fragment_hint_, max_message_size), header_size + fragment_size));
+        memcpy(fragment_buffer_.get(), raw_header.data(), header_size);
+        fragment_len_ = header_size;
     }
 
     /* Append fragment. */
-    size_t position = fragment_msg_.size();
-    size_t fragment_size = message->get_subheader().submessage_length();
-    fragment_msg_.resize(position + fragment_size);
-    message->get_raw_payload(fragment_msg_.data() + position, fragment_size);
+    reserve_fragment(fragment_len_ + fragment_size);
+    if (message->get_raw_payload(fragment_buffer_.get() + fragment_len_, fragment_size))
+    {
+        fragment_len_ += fragment_size;
+    }
 
     /* Check if last message. */
     fragment_message_available_ = (0 != (dds::xrce::FLAG_LAST_FRAGMENT & message->get_subheader().flags()));
@@ -393,10 +464,12 @@ inline bool ReliableInputStream::pop_fragment_message(InputMessagePtr& message)
     std::lock_guard<std::mutex> lock(mtx_);
     if (fragment_message_available_)
     {
-        message.reset(new InputMessage(fragment_msg_.data(), fragment_msg_.size()));
-        fragment_msg_.clear();
+        /* The reassembly buffer is handed over to the message. */
+        fragment_hint_ = fragment_len_;
+        message.reset(new InputMessage(std::move(fragment_buffer_), fragment_len_));
+        fragment_len_ = 0;
         fragment_message_available_ = false;
-        return true;
+        rv = true;
     }
     return rv;
 }
@@ -18,24 +18,40 @@
 #include <uxr/agent/config.hpp>
 #include <uxr/agent/message/Packet.hpp>
 #include <uxr/agent/utils/SeqNum.hpp>
+#include <uxr/agent/utils/RttEstimator.hpp>
 #include <uxr/agent/client/session/SessionInfo.hpp>
 
+#include <chrono>
 #include <memory>
+#include <deque>
 #include <queue>
 #include <mutex>
 #include <array>
-#include <map>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
 
+template<class T>
+inline size_t get_message_size(
+        const dds::xrce::MessageHeader& message_header,
+        const T& submessage)
+{
+    return message_header.getCdrSerializedSize() +
+           dds::xrce::SubmessageHeader().getCdrSerializedSize() +
+           submessage.getCdrSerializedSize();
+}
+
 /****************************************************************************************
  * None Output Stream.
  ****************************************************************************************/
 class NoneOutputStream
 {
 public:
-    NoneOutputStream() = default;
+    explicit NoneOutputStream(
+            size_t depth = BEST_EFFORT_STREAM_DEPTH)
+        : depth_(depth)
+    {}
 
     ~NoneOutputStream() = default;
 
@@ -56,6 +72,7 @@ public:
 
 private:
     std::queue<OutputMessagePtr> messages_;
+    size_t depth_;
     std::mutex mtx_;
 };
 
@@ -76,7 +93,7 @@ inline bool NoneOutputStream::push_submessage(
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if (BEST_EFFORT_STREAM_DEPTH > messages_.size())
+    if (depth_ > messages_.size())
     {
         /* Message header. */
         dds::xrce::MessageHeader message_header;
@@ -85,13 +102,17 @@ inline bool NoneOutputStream::push_submessage(
         message_header.sequence_nr(0x00);
         message_header.client_key(session_info.client_key);
 
-        /* Create message. */
-        OutputMessagePtr output_message(new OutputMessage(message_header, session_info.mtu));
-        if (output_message->append_submessage(id, submessage))
+        /* Create message, sized to fit the submessage only. */
+        const size_t message_size = get_message_size(message_header, submessage);
+        if (message_size <= session_info.mtu)
         {
-            /* Push message. */
-            messages_.push(std::move(output_message));
-            rv = true;
+            OutputMessagePtr output_message(new OutputMessage(message_header, message_size));
+            if (output_message->append_submessage(id, submessage, get_submessage_flags(submessage)))
+            {
+                /* Push message. */
+                messages_.push(std::move(output_message));
+                rv = true;
+            }
         }
     }
     return rv;
@@ -116,8 +137,13 @@ inline bool NoneOutputStream::pop_message(OutputMessagePtr& output_message)
 class BestEffortOutputStream
 {
 public:
-    BestEffortOutputStream()
+    explicit BestEffortOutputStream(
+            size_t depth = BEST_EFFORT_STREAM_DEPTH)
         : last_sent_(UINT16_MAX)
+        , depth_(depth)
+        , open_(false)
+        , flush_armed_(false)
+        , flush_timer_(0)
     {}
 
     ~BestEffortOutputStream() = default;
@@ -131,29 +157,48 @@ public:
 //    void promote_stream() { last_sent_ += 1; }
     void reset();
 
+    /**
+     * Coalesced submessages are appended to the last message while it is not popped and has room,
+     * such a message is sized to the MTU.
+     */
     template<class T>
     bool push_submessage(
             const SessionInfo& session_info,
             dds::xrce::StreamId stream_id,
             dds::xrce::SubmessageId submessage_id,
-            const T& submessage);
+            const T& submessage,
+            bool coalesce = false);
 
-    bool pop_message(OutputMessagePtr& output_message);
+    /* Without flush, a message still open to coalescing is kept. */
+    bool pop_message(
+            OutputMessagePtr& output_message,
+            bool flush = true);
+
+    bool arm_flush(SeqNum& seq_num);
+
+    bool is_flush_armed(SeqNum seq_num);
+
+    void set_flush_timer(uint64_t timer_id);
+
+    uint64_t get_flush_timer();
 
 private:
-    std::queue<OutputMessagePtr> messages_;
+    std::deque<OutputMessagePtr> messages_;
     SeqNum last_sent_;
+    size_t depth_;
+    bool open_;
+    bool flush_armed_;
+    uint64_t flush_timer_;
     std::mutex mtx_;
 };
 
 inline void BestEffortOutputStream::reset()
 {
     std::lock_guard<std::mutex> lock(mtx_);
-    while (!messages_.empty())
-    {
-        messages_.pop();
-    }
+    messages_.clear();
     last_sent_ = UINT16_MAX;
+    open_ = false;
+    flush_armed_ = false;
 }
 
 template<class T>
@@ -161,12 +206,22 @@ inline bool BestEffortOutputStream::push_submessage(
         const SessionInfo& session_info,
         dds::xrce::StreamId stream_id,
         dds::xrce::SubmessageId submessage_id,
-        const T& submessage)
+        const T& submessage,
+        bool coalesce)
 {
     bool rv = false;
+    const uint8_t flags = get_submessage_flags(submessage);
     std::lock_guard<std::mutex> lock(mtx_);
-    if (BEST_EFFORT_STREAM_DEPTH > messages_.size())
+    if (coalesce && open_ && messages_.back()->fits_submessage(submessage))
     {
+        /* Scattered submessages are copied, the message stays open. */
+        rv = messages_.back()->template append_submessage<T>(submessage_id, submessage, flags);
+    }
+    else if (depth_ > messages_.size())
+    {
+        open_ = false;
+        flush_armed_ = false;
+
         /* Message header. */
         dds::xrce::MessageHeader message_header;
         message_header.session_id(session_info.session_id);
@@ -174,57 +229,134 @@ inline bool BestEffortOutputStream::push_submessage(
         message_header.sequence_nr(last_sent_ + 1);
         message_header.client_key(session_info.client_key);
 
-        /* Create message. */
-        OutputMessagePtr output_message(new OutputMessage(message_header, session_info.mtu));
-        if (output_message->append_submessage(submessage_id, submessage))
+        /* Create message, sized to fit the submessage only unless it is open to coalescing. */
+        const size_t message_size = get_message_size(message_header, submessage);
+        if (message_size <= session_info.mtu)
         {
-            /* Push message. */
-            messages_.push(std::move(output_message));
-            last_sent_ += 1;
-            rv = true;
+            OutputMessagePtr output_message(
+                new OutputMessage(message_header, coalesce ? session_info.mtu : message_size));
+
+            /* A scattered tail would close the message, so an open message copies every submessage. */
+            if (coalesce
+                ? output_message->template append_submessage<T>(submessage_id, submessage, flags)
+                : output_message->append_submessage(submessage_id, submessage, flags))
+            {
+                /* Push message. */
+                messages_.push_back(std::move(output_message));
+                last_sent_ += 1;
+                open_ = coalesce;
+                rv = true;
+            }
         }
     }
     return rv;
 }
 
-inline bool BestEffortOutputStream::pop_message(OutputMessagePtr& output_message)
+inline bool BestEffortOutputStream::pop_message(
+        OutputMessagePtr& output_message,
+        bool flush)
 {
     std::lock_guard<std::mutex> lock(mtx_);
     bool rv = false;
-    if (!messages_.empty())
+    if (!messages_.empty() && (flush || !open_ || (1 < messages_.size())))
     {
         output_message = std::move(messages_.front());
-        messages_.pop();
+        messages_.pop_front();
+        if (messages_.empty())
+        {
+            open_ = false;
+            flush_armed_ = false;
+        }
         rv = true;
     }
     return rv;
 }
 
+/**
+ * Returns true when the stream has a message open to coalescing and nobody is already going to flush it,
+ * along with the sequence number of that message.
+ */
+inline bool BestEffortOutputStream::arm_flush(SeqNum& seq_num)
+{
+    bool rv = false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (open_ && !flush_armed_)
+    {
+        flush_armed_ = true;
+        seq_num = last_sent_;
+        rv = true;
+    }
+    return rv;
+}
+
+/* A flush timer outliving its message must not flush the next one. */
+inline bool BestEffortOutputStream::is_flush_armed(SeqNum seq_num)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return open_ && flush_armed_ && (last_sent_ == seq_num);
+}
+
+/* The flush timer is owned by the Processor, which cancels it when the next one is armed. */
+inline void BestEffortOutputStream::set_flush_timer(uint64_t timer_id)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    flush_timer_ = timer_id;
+}
+
+inline uint64_t BestEffortOutputStream::get_flush_timer()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return flush_timer_;
+}
+
 /****************************************************************************************
  * Reliable Output Stream.
  ****************************************************************************************/
 class ReliableOutputStream
 {
 public:
-    ReliableOutputStream()
-        : last_unacked_(UINT16_MAX)
+    explicit ReliableOutputStream(
+            size_t depth = RELIABLE_STREAM_DEPTH)
+        : history_(ring_capacity(depth))
+        , mask_(history_.size() - 1)
+        , depth_(depth)
+        , last_unacked_(UINT16_MAX)
         , last_sent_(UINT16_MAX)
         , first_unacked_(0x0000)
+        , open_(false)
+        , flush_armed_(false)
+        , heartbeat_armed_(false)
+        , unanswered_heartbeats_(0)
+        , heartbeat_time_()
+        , heartbeat_timer_(0)
+        , flush_timer_(0)
+        , rtt_(std::chrono::milliseconds(HEARTBEAT_PERIOD),
+               std::chrono::milliseconds(MIN_HEARTBEAT_PERIOD),
+               std::chrono::milliseconds(MAX_HEARTBEAT_PERIOD))
     {}
 
 //    bool push_message(OutputMessagePtr& output_message);
 
     void reset();
 
+    /**
+     * Coalesced submessages are appended to the last message while it is not sent and has room,
+     * so they share its sequence number. Such a message is sized to the MTU.
+     */
     template<class T>
     bool push_submessage(
             const SessionInfo& session_info,
             dds::xrce::StreamId stream_id,
             dds::xrce::SubmessageId submessage_id,
-            const T& submessage);
+            const T& submessage,
+            bool coalesce = false);
 
-    bool get_next_message(OutputMessagePtr& output_message);
+    /* Without flush, a message still open to coalescing is kept. */
+    bool get_next_message(
+            OutputMessagePtr& output_message,
+            bool flush = true);
 
+    /* Retransmissions are limited to sent messages. */
     bool get_message(
             SeqNum seq_num,
             OutputMessagePtr& output_message);
@@ -233,11 +365,53 @@ public:
 
     bool fill_heartbeat(dds::xrce::HEARTBEAT_Payload& heartbeat);
 
+    bool arm_heartbeat();
+
+    bool rearm_heartbeat();
+
+    std::chrono::milliseconds get_heartbeat_period();
+
+    void set_heartbeat_timer(uint64_t timer_id);
+
+    uint64_t get_heartbeat_timer();
+
+    bool arm_flush(SeqNum& seq_num);
+
+    bool is_flush_armed(SeqNum seq_num);
+
+    void set_flush_timer(uint64_t timer_id);
+
+    uint64_t get_flush_timer();
+
+private:
+    static size_t ring_capacity(size_t depth);
+
+    bool has_unacked() const { return !(last_unacked_ < first_unacked_); }
+
+    OutputMessagePtr& slot(SeqNum seq_num) { return history_[uint16_t(seq_num) & mask_]; }
+
+    void store(OutputMessagePtr&& output_message);
+
+    void shrink();
+
+    void close();
+
 private:
-    std::map<uint16_t, OutputMessagePtr> messages_;
+    /* Unacknowledged messages indexed by sequence number modulo a power of two. */
+    std::vector<OutputMessagePtr> history_;
+    size_t mask_;
+    size_t depth_;
     SeqNum last_unacked_;
     SeqNum last_sent_;
     SeqNum first_unacked_;
+    bool open_;
+    bool flush_armed_;
+    bool heartbeat_armed_;
+    uint8_t unanswered_heartbeats_;
+    std::chrono::steady_clock::time_point heartbeat_time_;
+    uint64_t heartbeat_timer_;
+    uint64_t flush_timer_;
+    utils::RttEstimator rtt_;
     std::mutex mtx_;
 };
 
@@ -260,7 +434,66 @@ inline void ReliableOutputStream::reset()
     last_unacked_ = UINT16_MAX;
     last_sent_ = UINT16_MAX;
     first_unacked_ = 0x0000;
-    messages_.clear();
+    for (auto& output_message : history_)
+    {
+        output_message.reset();
+    }
+    shrink();
+    open_ = false;
+    flush_armed_ = false;
+    unanswered_heartbeats_ = 0;
+    rtt_.reset();
+}
+
+/* Smallest power of two holding depth messages, so that the modulo survives the sequence number wraparound. */
+inline size_t ReliableOutputStream::ring_capacity(size_t depth)
+{
+    size_t rv = 1;
+    while (rv < depth)
+    {
+        rv <<= 1;
+    }
+    return rv;
+}
+
+/**
+ * A fragmented submessage may go beyond the depth, the ring is doubled to keep every fragment.
+ * Since a submessage is only pushed while the stream is below its depth, the ring holds at most the depth
+ * plus the fragments of one submessage, and shrink gets it back to its size once they are acknowledged.
+ */
+inline void ReliableOutputStream::store(OutputMessagePtr&& output_message)
+{
+    last_unacked_ += 1;
+    if (size_t(uint16_t(last_unacked_ - first_unacked_)) >= history_.size())
+    {
+        std::vector<OutputMessagePtr> history(history_.size() * 2);
+        const size_t mask = history.size() - 1;
+        for (SeqNum seq_num = first_unacked_; seq_num < last_unacked_; seq_num += 1)
+        {
+            history[uint16_t(seq_num) & mask] = std::move(slot(seq_num));
+        }
+        history_.swap(history);
+        mask_ = mask;
+    }
+    slot(last_unacked_) = std::move(output_message);
+}
+
+/* Releases the room taken by a fragmented submessage, to be called with no message left in the ring. */
+inline void ReliableOutputStream::shrink()
+{
+    const size_t capacity = ring_capacity(depth_);
+    if (history_.size() > capacity)
+    {
+        std::vector<OutputMessagePtr>(capacity).swap(history_);
+        mask_ = capacity - 1;
+    }
+}
+
+/* Once handed out, a message is shared with the transports and nothing can be appended to it. */
+inline void ReliableOutputStream::close()
+{
+    open_ = false;
+    flush_armed_ = false;
 }
 
 template<class T>
@@ -268,12 +501,21 @@ inline bool ReliableOutputStream::push_submessage(
         const SessionInfo& session_info,
         dds::xrce::StreamId stream_id,
         dds::xrce::SubmessageId submessage_id,
-        const T& submessage)
+        const T& submessage,
+        bool coalesce)
 {
     bool rv = false;
+    const uint8_t flags = get_submessage_flags(submessage);
     std::lock_guard<std::mutex> lock(mtx_);
-    if (last_unacked_ < first_unacked_ + SeqNum(RELIABLE_STREAM_DEPTH - 1))
+    if (coalesce && open_ && slot(last_unacked_)->fits_submessage(submessage))
+    {
+        /* Scattered submessages are copied, the message stays open. */
+        rv = slot(last_unacked_)->template append_submessage<T>(submessage_id, submessage, flags);
+    }
+    else if (last_unacked_ < first_unacked_ + SeqNum(uint16_t(depth_ - 1)))
     {
+        close();
+
         /* Message header. */
         dds::xrce::MessageHeader message_header;
         message_header.session_id(session_info.session_id);
@@ -283,7 +525,7 @@ inline bool ReliableOutputStream::push_submessage(
         /* Submessage header. */
         dds::xrce::SubmessageHeader submessage_header;
         submessage_header.submessage_id(submessage_id);
-        submessage_header.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS);
+        submessage_header.flags(flags);
         submessage_header.submessage_length(uint16_t(submessage.getCdrSerializedSize()));
 
         /* Compute message size. */
@@ -295,13 +537,18 @@ inline bool ReliableOutputStream::push_submessage(
         if ((header_size + submessage_size) <= session_info.mtu)
         {
             /* Create message. */
-            last_unacked_ += 1;
-            message_header.sequence_nr(last_unacked_);
-            OutputMessagePtr output_message(new OutputMessage(message_header, header_size + submessage_size));
-            if (output_message->append_submessage(submessage_id, submessage))
+            message_header.sequence_nr(last_unacked_ + 1);
+            OutputMessagePtr output_message(
+                new OutputMessage(message_header, coalesce ? session_info.mtu : header_size + submessage_size));
+
+            /* A scattered tail would close the message, so an open message copies every submessage. */
+            if (coalesce
+                ? output_message->template append_submessage<T>(submessage_id, submessage, flags)
+                : output_message->append_submessage(submessage_id, submessage, flags))
             {
                 /* Push message. */
-                messages_.insert(std::make_pair(last_unacked_, std::move(output_message)));
+                store(std::move(output_message));
+                open_ = coalesce;
                 rv = true;
             }
         }
@@ -331,20 +578,19 @@ inline bool ReliableOutputStream::push_submessage(
                 else
                 {
                     fragment_size = uint16_t(submessage_size - serialized_size);
-                    fragment_subheader.flags(submessage_header.flags() | dds::xrce::FLAG_LAST_FRAGMENT);
+                    fragment_subheader.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS | dds::xrce::FLAG_LAST_FRAGMENT);
                 }
                 fragment_subheader.submessage_length(fragment_size);
 
                 const size_t current_message_size = header_size + subheader_size + fragment_size;
 
                 /* Create message. */
-                last_unacked_ += 1;
-                message_header.sequence_nr(last_unacked_);
+                message_header.sequence_nr(last_unacked_ + 1);
                 OutputMessagePtr output_message(new OutputMessage(message_header, current_message_size));
                 if (output_message->append_fragment(fragment_subheader,  buf.get() + serialized_size, fragment_size))
                 {
                     /* Push message. */
-                    messages_.insert(std::make_pair(last_unacked_, std::move(output_message)));
+                    store(std::move(output_message));
                     serialized_size += fragment_size;
                 }
                 else
@@ -359,14 +605,20 @@ inline bool ReliableOutputStream::push_submessage(
     return rv;
 }
 
-inline bool ReliableOutputStream::get_next_message(OutputMessagePtr& output_message)
+inline bool ReliableOutputStream::get_next_message(
+        OutputMessagePtr& output_message,
+        bool flush)
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    if (last_sent_ < last_unacked_)
+    if ((last_sent_ < last_unacked_) && (flush || !open_ || (last_sent_ + 1 != last_unacked_)))
     {
         last_sent_ += 1;
-        output_message = messages_.at(last_sent_);
+        output_message = slot(last_sent_);
+        if (last_sent_ == last_unacked_)
+        {
+            close();
+        }
         rv = true;
     }
     return rv;
@@ -378,10 +630,9 @@ inline bool ReliableOutputStream::get_message(
 {
     bool rv = false;
     std::lock_guard<std::mutex> lock(mtx_);
-    auto it = messages_.find(seq_num);
-    if (it != messages_.end())
+    if (!(seq_num < first_unacked_) && !(last_sent_ < seq_num))
     {
-        output_message = it->second;
+        output_message = slot(seq_num);
         rv = true;
     }
     return rv;
@@ -394,17 +645,125 @@ inline void ReliableOutputStream::update_from_acknack(SeqNum first_unacked)
     {
         while (first_unacked > first_unacked_)
         {
-            messages_.erase(first_unacked_);
+            slot(first_unacked_).reset();
             first_unacked_ += 1;
         }
+        if (!has_unacked())
+        {
+            shrink();
+        }
+
+        /* Karn's rule, the round trip is only measured when a single heartbeat may have been answered. */
+        if (1 == unanswered_heartbeats_)
+        {
+            rtt_.update(std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - heartbeat_time_));
+        }
+        unanswered_heartbeats_ = 0;
     }
 }
 
+/* Only sent messages are announced, a message still open to coalescing is not on the wire yet. */
 inline bool ReliableOutputStream::fill_heartbeat(dds::xrce::HEARTBEAT_Payload& heartbeat)
 {
+    std::lock_guard<std::mutex> lock(mtx_);
     heartbeat.first_unacked_seq_nr(first_unacked_);
-    heartbeat.last_unacked_seq_nr(last_unacked_);
-    return !messages_.empty();
+    heartbeat.last_unacked_seq_nr(last_sent_);
+
+    /* Once everything is acknowledged the heartbeat timer is not rescheduled. */
+    heartbeat_armed_ = has_unacked();
+    if (heartbeat_armed_)
+    {
+        /* The previous heartbeat timed out. */
+        if (0 < unanswered_heartbeats_)
+        {
+            rtt_.back_off();
+        }
+        if (UINT8_MAX > unanswered_heartbeats_)
+        {
+            ++unanswered_heartbeats_;
+        }
+        heartbeat_time_ = std::chrono::steady_clock::now();
+    }
+    return heartbeat_armed_;
+}
+
+/* Returns true when the stream has unacknowledged messages and nobody is already heartbeating it. */
+inline bool ReliableOutputStream::arm_heartbeat()
+{
+    bool rv = false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!heartbeat_armed_ && has_unacked())
+    {
+        heartbeat_armed_ = true;
+        rv = true;
+    }
+    return rv;
+}
+
+/* Called once the heartbeat timer has been cancelled, returns true when it has to be scheduled again. */
+inline bool ReliableOutputStream::rearm_heartbeat()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    heartbeat_armed_ = has_unacked();
+    return heartbeat_armed_;
+}
+
+/* Retransmission timeout of the stream, the heartbeat timer is scheduled with it. */
+inline std::chrono::milliseconds ReliableOutputStream::get_heartbeat_period()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return rtt_.get_rto();
+}
+
+/* The heartbeat timer is owned by the Processor, the stream only keeps its identifier. */
+inline void ReliableOutputStream::set_heartbeat_timer(uint64_t timer_id)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    heartbeat_timer_ = timer_id;
+}
+
+inline uint64_t ReliableOutputStream::get_heartbeat_timer()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return heartbeat_timer_;
+}
+
+/**
+ * Returns true when the stream has a message open to coalescing and nobody is already going to flush it,
+ * along with the sequence number of that message.
+ */
+inline bool ReliableOutputStream::arm_flush(SeqNum& seq_num)
+{
+    bool rv = false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (open_ && !flush_armed_)
+    {
+        flush_armed_ = true;
+        seq_num = last_unacked_;
+        rv = true;
+    }
+    return rv;
+}
+
+/* A flush timer outliving its message must not flush the next one. */
+inline bool ReliableOutputStream::is_flush_armed(SeqNum seq_num)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return open_ && flush_armed_ && (last_unacked_ == seq_num);
+}
+
+/* The flush timer is owned by the Processor, which cancels it when the next one is armed. */
+inline void ReliableOutputStream::set_flush_timer(uint64_t timer_id)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    flush_timer_ = timer_id;
+}
+
+inline uint64_t ReliableOutputStream::get_flush_timer()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return flush_timer_;
 }
 
 } // namespace uxr
@@ -17,11 +17,9 @@
 
 #include <uxr/agent/object/XRCEObject.hpp>
 
-#include <condition_variable>
 #include <mutex>
-#include <thread>
 #include <functional>
-#include <atomic>
+#include <memory>
 
 namespace eprosima {
 namespace uxr {
@@ -39,9 +37,12 @@ struct ReadCallbackArgs
     dds::xrce::StreamId stream_id;
     dds::xrce::ObjectId object_id;
     dds::xrce::RequestId request_id;
+    dds::xrce::DataFormat data_format;
+    size_t max_data_size;
 };
 
-typedef const std::function<void (const ReadCallbackArgs&, std::vector<uint8_t>)> read_callback;
+/* The buffer holds the samples serialized in the requested format, ready to be sent as a scattered tail. */
+typedef const std::function<void (const ReadCallbackArgs&, std::shared_ptr<const std::vector<uint8_t>>)> read_callback;
 
 /**
  * @brief The DataReader class
@@ -88,16 +89,13 @@ private:
 
     bool stop_read();
 
-    void read_task(
-        dds::xrce::DataDeliveryControl delivery_control,
-        read_callback read_cb,
-        ReadCallbackArgs cb_args);
-
 private:
+    /* Ongoing READ_DATA request, run by the shared DeliveryExecutor when the middleware notifies new data. */
+    class Delivery;
+
     std::shared_ptr<Subscriber> subscriber_;
     std::shared_ptr<Topic> topic_;
-    std::atomic<bool> running_cond_;
-    std::thread read_thread_;
+    std::shared_ptr<Delivery> delivery_;
     std::mutex mtx_;
 };
 
@@ -0,0 +1,154 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_DATAREADER_DELIVERY_EXECUTOR_HPP_
+#define UXR_AGENT_DATAREADER_DELIVERY_EXECUTOR_HPP_
+
+#include <uxr/agent/utils/TimerWheel.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Fixed pool of threads running the data delivery of every DataReader.
+ * Tasks are posted either to run as soon as possible or at a given time point,
+ * so the number of threads does not depend on the number of readers.
+ * Timed tasks are kept in a utils::TimerWheel with millisecond resolution.
+ */
+class DeliveryExecutor
+{
+public:
+    typedef std::function<void ()> Task;
+    typedef std::chrono::steady_clock::time_point TimePoint;
+    typedef utils::TimerWheel::TimerId TimerId;
+
+    explicit DeliveryExecutor(
+            size_t thread_count)
+        : running_cond_{true}
+        , timers_{utils::TimerWheel::to_tick(std::chrono::steady_clock::now())}
+    {
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            threads_.emplace_back(&DeliveryExecutor::run, this);
+        }
+    }
+
+    ~DeliveryExecutor()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        running_cond_ = false;
+        lock.unlock();
+        cond_var_.notify_all();
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    DeliveryExecutor(DeliveryExecutor&&) = delete;
+    DeliveryExecutor(const DeliveryExecutor&) = delete;
+    DeliveryExecutor& operator=(DeliveryExecutor&&) = delete;
+    DeliveryExecutor& operator=(const DeliveryExecutor&) = delete;
+
+    void post(
+            Task task)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        ready_tasks_.push_back(std::move(task));
+        lock.unlock();
+        cond_var_.notify_one();
+    }
+
+    TimerId post_at(
+            TimePoint time_point,
+            Task task)
+    {
+        /* Rounded up, a task never runs before its time point. */
+        utils::TimerWheel::Tick deadline = utils::TimerWheel::to_tick(time_point);
+        if (utils::TimerWheel::to_time_point(deadline) < time_point)
+        {
+            ++deadline;
+        }
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        TimerId rv = timers_.schedule(deadline, std::move(task));
+        lock.unlock();
+        cond_var_.notify_one();
+        return rv;
+    }
+
+    bool cancel(
+            TimerId timer_id)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return timers_.cancel(timer_id);
+    }
+
+    size_t get_thread_count() const { return threads_.size(); }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (running_cond_)
+        {
+            /* Expired timers go behind the ready tasks. */
+            timers_.advance(utils::TimerWheel::to_tick(std::chrono::steady_clock::now()), expired_tasks_);
+            for (auto& task : expired_tasks_)
+            {
+                ready_tasks_.push_back(std::move(task));
+            }
+            expired_tasks_.clear();
+
+            if (!ready_tasks_.empty())
+            {
+                Task task = std::move(ready_tasks_.front());
+                ready_tasks_.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+            else if (!timers_.empty())
+            {
+                cond_var_.wait_until(lock, utils::TimerWheel::to_time_point(timers_.next_event()));
+            }
+            else
+            {
+                cond_var_.wait(lock);
+            }
+        }
+    }
+
+private:
+    bool running_cond_;
+    std::deque<Task> ready_tasks_;
+    utils::TimerWheel timers_;
+    std::vector<Task> expired_tasks_;
+    std::vector<std::thread> threads_;
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_DATAREADER_DELIVERY_EXECUTOR_HPP_
@@ -0,0 +1,388 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_DATAREADER_SAMPLE_BATCH_HPP_
+#define UXR_AGENT_DATAREADER_SAMPLE_BATCH_HPP_
+
+#include <uxr/agent/types/XRCETypes.hpp>
+#include <uxr/agent/types/ByteView.hpp>
+
+#include <fastcdr/Cdr.h>
+#include <fastcdr/exceptions/Exception.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Samples of a READ_DATA request serialized in the given format, as the payload of a DATA submessage
+ * following its BaseObjectRequest.
+ * FORMAT_DATA and FORMAT_SAMPLE carry a single sample whose data runs to the end of the submessage,
+ * FORMAT_DATA_SEQ, FORMAT_SAMPLE_SEQ and FORMAT_PACKED_SAMPLES carry as many samples as fit in max_size,
+ * each one with its length.
+ * The payload is little endian and aligned as CDR from a 4-byte boundary, which is where it starts.
+ * The same layout is used by WRITE_DATA, whose samples are split by deserialize() into views of the payload.
+ */
+class SampleBatch
+{
+public:
+    /* The payload is written into the given buffer, whose capacity is reused. */
+    SampleBatch(
+            dds::xrce::DataFormat format,
+            size_t max_size,
+            std::vector<uint8_t>&& buffer = std::vector<uint8_t>());
+
+    SampleBatch(SampleBatch&&) = delete;
+    SampleBatch(const SampleBatch&) = delete;
+    SampleBatch& operator=(SampleBatch&&) = delete;
+    SampleBatch& operator=(const SampleBatch&) = delete;
+
+    static bool is_valid_format(dds::xrce::DataFormat format);
+
+    /* Returns false on a truncated payload, the samples split so far are kept. */
+    static bool deserialize(
+            dds::xrce::DataFormat format,
+            const ByteView& payload,
+            bool little_endian,
+            std::vector<ByteView>& samples);
+
+    /* The first sample always fits, a larger one is sent alone. */
+    bool fits(size_t data_size) const;
+
+    void append(
+            const ByteView& data,
+            uint32_t sequence_number,
+            uint32_t time_offset);
+
+    size_t get_count() const { return count_; }
+
+    size_t get_size() const { return buffer_.size(); }
+
+    std::vector<uint8_t> release();
+
+private:
+    static size_t align(size_t offset, size_t alignment) { return (offset + alignment - 1) & ~(alignment - 1); }
+
+    size_t get_sample_size(size_t data_size) const;
+
+    void put_uint8(uint8_t value);
+
+    void put_uint16(uint16_t value);
+
+    void put_uint32(uint32_t value);
+
+    void put_info(uint32_t sequence_number, uint32_t time_offset);
+
+    void put_data(const ByteView& data);
+
+    static bool deserialize_data(
+            fastcdr::Cdr& deserializer,
+            const ByteView& payload,
+            ByteView& data);
+
+private:
+    /* Packed samples tell their sequence number as an 8-bit delta from the first one. */
+    static constexpr size_t max_packed_samples_ = 256;
+    static constexpr size_t packed_count_offset_ = 12;
+
+    const dds::xrce::DataFormat format_;
+    const size_t max_size_;
+    std::vector<uint8_t> buffer_;
+    size_t count_;
+    uint32_t base_sequence_number_;
+    uint32_t base_time_offset_;
+};
+
+inline SampleBatch::SampleBatch(
+        dds::xrce::DataFormat format,
+        size_t max_size,
+        std::vector<uint8_t>&& buffer)
+    : format_(format)
+    , max_size_(max_size)
+    , buffer_(std::move(buffer))
+    , count_(0)
+    , base_sequence_number_(0)
+    , base_time_offset_(0)
+{
+    buffer_.clear();
+    buffer_.reserve(max_size);
+}
+
+inline bool SampleBatch::is_valid_format(dds::xrce::DataFormat format)
+{
+    return (dds::xrce::FORMAT_DATA == format) ||
+           (dds::xrce::FORMAT_SAMPLE == format) ||
+           (dds::xrce::FORMAT_DATA_SEQ == format) ||
+           (dds::xrce::FORMAT_SAMPLE_SEQ == format) ||
+           (dds::xrce::FORMAT_PACKED_SAMPLES == format);
+}
+
+inline bool SampleBatch::deserialize(
+        dds::xrce::DataFormat format,
+        const ByteView& payload,
+        bool little_endian,
+        std::vector<ByteView>& samples)
+{
+    /* Read only, the views point into the payload. */
+    bool rv = true;
+    fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(const_cast<uint8_t*>(payload.data())), payload.size());
+    fastcdr::Cdr deserializer(
+                fastbuffer, little_endian ? fastcdr::Cdr::LITTLE_ENDIANNESS : fastcdr::Cdr::BIG_ENDIANNESS);
+    try
+    {
+        dds::xrce::SampleInfo info;
+        dds::xrce::SampleInfoDelta info_delta;
+        ByteView data;
+        uint32_t count = 0;
+        switch (format)
+        {
+            case dds::xrce::FORMAT_DATA:
+                samples.push_back(payload);
+                break;
+            case dds::xrce::FORMAT_SAMPLE:
+                deserializer >> info;
+                samples.emplace_back(payload.data() + deserializer.getSerializedDataLength(),
+                                     payload.size() - deserializer.getSerializedDataLength());
+                break;
+            case dds::xrce::FORMAT_DATA_SEQ:
+                deserializer >> count;
+                for (uint32_t i = 0; rv && (i < count); ++i)
+                {
+                    rv = deserialize_data(deserializer, payload, data);
+                    if (rv)
+                    {
+                        samples.push_back(data);
+                    }
+                }
+                break;
+            case dds::xrce::FORMAT_SAMPLE_SEQ:
+                deserializer >> count;
+                for (uint32_t i = 0; rv && (i < count); ++i)
+                {
+                    deserializer >> info;
+                    rv = deserialize_data(deserializer, payload, data);
+                    if (rv)
+                    {
+                        samples.push_back(data);
+                    }
+                }
+                break;
+            case dds::xrce::FORMAT_PACKED_SAMPLES:
+                deserializer >> info >> count;
+                for (uint32_t i = 0; rv && (i < count); ++i)
+                {
+                    deserializer >> info_delta;
+                    rv = deserialize_data(deserializer, payload, data);
+                    if (rv)
+                    {
+                        samples.push_back(data);
+                    }
+                }
+                break;
+            default:
+                rv = false;
+                break;
+        }
+    }
+    catch(eprosima::fastcdr::exception::NotEnoughMemoryException & /*exception*/)
+    {
+        rv = false;
+    }
+    return rv;
+}
+
+inline bool SampleBatch::fits(size_t data_size) const
+{
+    bool rv = false;
+    switch (format_)
+    {
+        case dds::xrce::FORMAT_DATA_SEQ:
+        case dds::xrce::FORMAT_SAMPLE_SEQ:
+            rv = (0 == count_) || (buffer_.size() + get_sample_size(data_size) <= max_size_);
+            break;
+        case dds::xrce::FORMAT_PACKED_SAMPLES:
+            rv = (0 == count_) ||
+                 ((count_ < max_packed_samples_) && (buffer_.size() + get_sample_size(data_size) <= max_size_));
+            break;
+        default:
+            rv = (0 == count_);
+            break;
+    }
+    return rv;
+}
+
+inline void SampleBatch::append(
+        const ByteView& data,
+        uint32_t sequence_number,
+        uint32_t time_offset)
+{
+    switch (format_)
+    {
+        case dds::xrce::FORMAT_DATA:
+            buffer_.insert(buffer_.end(), data.begin(), data.end());
+            break;
+        case dds::xrce::FORMAT_SAMPLE:
+            put_info(sequence_number, time_offset);
+            buffer_.insert(buffer_.end(), data.begin(), data.end());
+            break;
+        case dds::xrce::FORMAT_DATA_SEQ:
+            if (0 == count_)
+            {
+                put_uint32(0);
+            }
+            put_data(data);
+            break;
+        case dds::xrce::FORMAT_SAMPLE_SEQ:
+            if (0 == count_)
+            {
+                put_uint32(0);
+            }
+            put_info(sequence_number, time_offset);
+            put_data(data);
+            break;
+        case dds::xrce::FORMAT_PACKED_SAMPLES:
+        {
+            /* SampleInfo of the first sample, then a SampleInfoDelta per sample. */
+            if (0 == count_)
+            {
+                base_sequence_number_ = sequence_number;
+                base_time_offset_ = time_offset;
+                put_info(sequence_number, time_offset);
+                put_uint32(0);
+            }
+            const uint32_t deciseconds = (time_offset - base_time_offset_) / 100;
+            put_uint8(0x00);
+            put_uint8(uint8_t(sequence_number - base_sequence_number_));
+            put_uint16(uint16_t(std::min(deciseconds, uint32_t(UINT16_MAX))));
+            put_data(data);
+            break;
+        }
+        default:
+            break;
+    }
+    ++count_;
+}
+
+inline std::vector<uint8_t> SampleBatch::release()
+{
+    /* Sequence length, written once every sample is in. */
+    size_t count_offset = buffer_.size();
+    switch (format_)
+    {
+        case dds::xrce::FORMAT_DATA_SEQ:
+        case dds::xrce::FORMAT_SAMPLE_SEQ:
+            count_offset = 0;
+            break;
+        case dds::xrce::FORMAT_PACKED_SAMPLES:
+            count_offset = packed_count_offset_;
+            break;
+        default:
+            break;
+    }
+    if (count_offset + 4 <= buffer_.size())
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            buffer_[count_offset + i] = uint8_t(count_ >> (8 * i));
+        }
+    }
+
+    count_ = 0;
+    std::vector<uint8_t> rv;
+    rv.swap(buffer_);
+    return rv;
+}
+
+inline size_t SampleBatch::get_sample_size(size_t data_size) const
+{
+    size_t offset = buffer_.size();
+    switch (format_)
+    {
+        case dds::xrce::FORMAT_SAMPLE_SEQ:
+            offset = align(offset + 1, 4) + 8;
+            break;
+        case dds::xrce::FORMAT_PACKED_SAMPLES:
+            offset = align(offset + 2, 2) + 2;
+            break;
+        default:
+            break;
+    }
+    offset = align(offset, 4) + 4 + data_size;
+    return offset - buffer_.size();
+}
+
+inline void SampleBatch::put_uint8(uint8_t value)
+{
+    buffer_.push_back(value);
+}
+
+inline void SampleBatch::put_uint16(uint16_t value)
+{
+    buffer_.resize(align(buffer_.size(), 2), 0x00);
+    buffer_.push_back(uint8_t(value));
+    buffer_.push_back(uint8_t(value >> 8));
+}
+
+inline void SampleBatch::put_uint32(uint32_t value)
+{
+    buffer_.resize(align(buffer_.size(), 4), 0x00);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        buffer_.push_back(uint8_t(value >> (8 * i)));
+    }
+}
+
+inline void SampleBatch::put_info(
+        uint32_t sequence_number,
+        uint32_t time_offset)
+{
+    /* The middleware does not report instance states, samples are alive. */
+    put_uint8(0x00);
+    put_uint32(sequence_number);
+    put_uint32(time_offset);
+}
+
+inline void SampleBatch::put_data(const ByteView& data)
+{
+    put_uint32(uint32_t(data.size()));
+    buffer_.insert(buffer_.end(), data.begin(), data.end());
+}
+
+inline bool SampleBatch::deserialize_data(
+        fastcdr::Cdr& deserializer,
+        const ByteView& payload,
+        ByteView& data)
+{
+    /* The length is checked against the payload before taking the view. */
+    bool rv = false;
+    uint32_t length = 0;
+    deserializer >> length;
+    const size_t offset = deserializer.getSerializedDataLength();
+    if (length <= payload.size() - offset)
+    {
+        deserializer.jump(length);
+        data = ByteView(payload.data() + offset, length);
+        rv = true;
+    }
+    return rv;
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_DATAREADER_SAMPLE_BATCH_HPP_
@@ -16,6 +16,7 @@
 #define UXR_AGENT_DATAWRITER_DATAWRITER_HPP_
 
 #include <uxr/agent/object/XRCEObject.hpp>
+#include <uxr/agent/types/ByteView.hpp>
 #include <string>
 #include <set>
 
@@ -45,8 +46,8 @@ public:
     bool matched(const dds::xrce::ObjectVariant& new_object_rep) const override;
     Middleware& get_middleware() const override;
 
-    bool write(dds::xrce::WRITE_DATA_Payload_Data& write_data);
-    bool write(const std::vector<uint8_t>& data);
+    bool write(const ByteView& data);
+    bool write_batch(const std::vector<ByteView>& batch);
 
 private:
     DataWriter(const dds::xrce::ObjectId& object_id,
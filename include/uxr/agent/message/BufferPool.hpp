@@ -0,0 +1,237 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_MESSAGE_BUFFER_POOL_HPP_
+#define UXR_AGENT_MESSAGE_BUFFER_POOL_HPP_
+
+#include <uxr/agent/utils/LockFreeQueue.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+class BufferPool;
+
+/**
+ * Owning handle of a message buffer. A buffer acquired from a BufferPool is given back to it
+ * on destruction, any other buffer is deleted.
+ */
+class PooledBuffer
+{
+public:
+    PooledBuffer()
+        : data_(nullptr)
+        , size_(0)
+        , pool_(nullptr)
+    {}
+
+    explicit PooledBuffer(
+            size_t size)
+        : data_(new uint8_t[size])
+        , size_(size)
+        , pool_(nullptr)
+    {}
+
+    PooledBuffer(
+            uint8_t* data,
+            size_t size,
+            BufferPool* pool)
+        : data_(data)
+        , size_(size)
+        , pool_(pool)
+    {}
+
+    ~PooledBuffer()
+    {
+        reset();
+    }
+
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : data_(other.data_)
+        , size_(other.size_)
+        , pool_(other.pool_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.pool_ = nullptr;
+    }
+
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            data_ = other.data_;
+            size_ = other.size_;
+            pool_ = other.pool_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.pool_ = nullptr;
+        }
+        return *this;
+    }
+
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    uint8_t* get() const { return data_; }
+
+    size_t size() const { return size_; }
+
+    bool is_pooled() const { return nullptr != pool_; }
+
+    void reset();
+
+private:
+    uint8_t* data_;
+    size_t size_;
+    BufferPool* pool_;
+};
+
+/**
+ * Lock-free cache of fixed-size buffers. Acquiring from an empty pool allocates a new buffer,
+ * and releasing into a full pool deletes it, so the pool never blocks nor fails.
+ */
+class BufferPool
+{
+public:
+    BufferPool(
+            size_t buffer_size,
+            size_t max_buffers)
+        : buffer_size_(buffer_size)
+        , free_buffers_(max_buffers)
+    {}
+
+    ~BufferPool()
+    {
+        uint8_t* buffer;
+        while (free_buffers_.try_pop(buffer))
+        {
+            delete[] buffer;
+        }
+    }
+
+    BufferPool(BufferPool&&) = delete;
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(BufferPool&&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    PooledBuffer acquire()
+    {
+        uint8_t* buffer;
+        if (!free_buffers_.try_pop(buffer))
+        {
+            buffer = new uint8_t[buffer_size_];
+        }
+        return PooledBuffer(buffer, buffer_size_, this);
+    }
+
+    void release(
+            uint8_t* buffer)
+    {
+        if (!free_buffers_.try_push(buffer))
+        {
+            delete[] buffer;
+        }
+    }
+
+    size_t get_buffer_size() const { return buffer_size_; }
+
+private:
+    const size_t buffer_size_;
+    utils::LockFreeQueue<uint8_t*> free_buffers_;
+};
+
+/**
+ * Lock-free cache of the vectors which carry samples as the scattered tail of output messages.
+ * A vector is given back, keeping its capacity, once the last message referencing it is gone,
+ * unless it grew beyond max_capacity.
+ */
+class SampleBufferPool
+{
+public:
+    SampleBufferPool(
+            size_t max_capacity,
+            size_t max_buffers)
+        : max_capacity_(max_capacity)
+        , free_buffers_(max_buffers)
+    {}
+
+    ~SampleBufferPool()
+    {
+        std::vector<uint8_t>* buffer;
+        while (free_buffers_.try_pop(buffer))
+        {
+            delete buffer;
+        }
+    }
+
+    SampleBufferPool(SampleBufferPool&&) = delete;
+    SampleBufferPool(const SampleBufferPool&) = delete;
+    SampleBufferPool& operator=(SampleBufferPool&&) = delete;
+    SampleBufferPool& operator=(const SampleBufferPool&) = delete;
+
+    /* The vector is empty, its capacity is the one left by its previous use. */
+    std::shared_ptr<std::vector<uint8_t>> acquire()
+    {
+        std::vector<uint8_t>* buffer;
+        if (!free_buffers_.try_pop(buffer))
+        {
+            buffer = new std::vector<uint8_t>();
+        }
+        return std::shared_ptr<std::vector<uint8_t>>(buffer, [this](std::vector<uint8_t>* released)
+        {
+            release(released);
+        });
+    }
+
+private:
+    void release(
+            std::vector<uint8_t>* buffer)
+    {
+        buffer->clear();
+        if ((max_capacity_ < buffer->capacity()) || !free_buffers_.try_push(buffer))
+        {
+            delete buffer;
+        }
+    }
+
+private:
+    const size_t max_capacity_;
+    utils::LockFreeQueue<std::vector<uint8_t>*> free_buffers_;
+};
+
+inline void PooledBuffer::reset()
+{
+    if (nullptr != pool_)
+    {
+        pool_->release(data_);
+    }
+    else
+    {
+        delete[] data_;
+    }
+    data_ = nullptr;
+    size_ = 0;
+    pool_ = nullptr;
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_MESSAGE_BUFFER_POOL_HPP_
@@ -17,6 +17,8 @@
 
 #include <uxr/agent/types/MessageHeader.hpp>
 #include <uxr/agent/types/SubMessageHeader.hpp>
+#include <uxr/agent/message/BufferPool.hpp>
+#include <uxr/agent/types/ByteView.hpp>
 
 #include <fastcdr/Cdr.h>
 #include <fastcdr/exceptions/Exception.h>
@@ -30,25 +32,39 @@ public:
     InputMessage(
             uint8_t* buf,
             size_t len)
-        : buf_(new uint8_t[len]),
+        : buffer_(acquire_buffer(len)),
           len_(len),
           header_(),
           subheader_(),
-          fastbuffer_(reinterpret_cast<char*>(buf_), len_),
+          fastbuffer_(reinterpret_cast<char*>(buffer_.get()), len_),
           deserializer_(fastbuffer_)
     {
-        memcpy(buf_, buf, len);
+        memcpy(buffer_.get(), buf, len);
         deserialize(header_);
     }
 
-    uint8_t* get_buf() const { return buf_; }
+    /* Takes ownership of a buffer already holding the message, avoiding the copy. */
+    InputMessage(
+            PooledBuffer&& buffer,
+            size_t len)
+        : buffer_(std::move(buffer)),
+          len_(len),
+          header_(),
+          subheader_(),
+          fastbuffer_(reinterpret_cast<char*>(buffer_.get()), len_),
+          deserializer_(fastbuffer_)
+    {
+        deserialize(header_);
+    }
+
+    /* Returns a buffer of at least len bytes, taken from the input pool when it fits in a slab. */
+    static PooledBuffer acquire_buffer(size_t len = 0);
+
+    uint8_t* get_buf() const { return buffer_.get(); }
 
     size_t get_len() const { return len_; }
 
-    ~InputMessage()
-    {
-        delete[] buf_;
-    }
+    ~InputMessage() = default;
 
     InputMessage(InputMessage&&) = delete;
     InputMessage(const InputMessage&) = delete;
@@ -66,6 +82,9 @@ public:
 
     bool get_raw_payload(uint8_t* buf, size_t len);
 
+    /* Points the view to the next len bytes of the message without copying them. */
+    bool get_payload_view(ByteView& view, size_t len);
+
     bool prepare_next_submessage();
 
 private:
@@ -75,7 +94,7 @@ private:
     void log_error();
 
 private:
-    uint8_t* buf_;
+    PooledBuffer buffer_;
     size_t len_;
     dds::xrce::MessageHeader header_;
     dds::xrce::SubmessageHeader subheader_;
@@ -105,12 +124,12 @@ inline uint8_t InputMessage::get_raw_header(std::array<uint8_t, 8>& buf)
     uint8_t rv;
     if (128 > header_.session_id())
     {
-        memcpy(buf.data(), buf_, 8);
+        memcpy(buf.data(), buffer_.get(), 8);
         rv = 8;
     }
     else
     {
-        memcpy(buf.data(), buf_, 4);
+        memcpy(buf.data(), buffer_.get(), 4);
         rv = 4;
     }
     return rv;
@@ -135,6 +154,23 @@ inline bool InputMessage::get_raw_payload(uint8_t* buf, size_t len)
     return rv;
 }
 
+inline bool InputMessage::get_payload_view(ByteView& view, size_t len)
+{
+    bool rv = false;
+    const size_t offset = deserializer_.getSerializedDataLength();
+    if (len <= len_ - offset)
+    {
+        deserializer_.jump(len);
+        view = ByteView(buffer_.get() + offset, len);
+        rv = true;
+    }
+    else
+    {
+        log_error();
+    }
+    return rv;
+}
+
 template<class T>
 inline bool InputMessage::deserialize(T& data)
 {
@@ -18,40 +18,104 @@
 #include <uxr/agent/types/MessageHeader.hpp>
 #include <uxr/agent/types/SubMessageHeader.hpp>
 #include <uxr/agent/utils/Functions.hpp>
+#include <uxr/agent/message/BufferPool.hpp>
 
 #include <fastcdr/Cdr.h>
 #include <fastcdr/exceptions/Exception.h>
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace eprosima {
 namespace uxr {
 
+/**
+ * Submessage made of a serialized head followed by raw bytes kept in their own buffer,
+ * so that transports able to gather can send them without copying them into the message.
+ * The format of a DATA submessage is told by its flags.
+ */
+template<class T>
+struct ScatteredSubmessage
+{
+    const T& head;
+    std::shared_ptr<const std::vector<uint8_t>> tail;
+    dds::xrce::DataFormat format;
+
+    size_t getCdrSerializedSize(size_t current_alignment = 0) const
+    {
+        return head.getCdrSerializedSize(current_alignment) + tail->size();
+    }
+
+    void serialize(fastcdr::Cdr& serializer) const
+    {
+        head.serialize(serializer);
+        serializer.serializeArray(tail->data(), tail->size());
+    }
+};
+
+/* Flags of the submessage header. */
+template<class T>
+inline uint8_t get_submessage_flags(
+        const T& /*data*/)
+{
+    return dds::xrce::FLAG_LITTLE_ENDIANNESS;
+}
+
+template<class T>
+inline uint8_t get_submessage_flags(
+        const ScatteredSubmessage<T>& data)
+{
+    return dds::xrce::FLAG_LITTLE_ENDIANNESS | (data.format & dds::xrce::FORMAT_MASK);
+}
+
 class OutputMessage
 {
 public:
     OutputMessage(
             const dds::xrce::MessageHeader& header,
             size_t len)
-        : buf_(new uint8_t[len]{0}),
+        : buffer_(acquire_buffer(len)),
           len_(len),
-          fastbuffer_(reinterpret_cast<char*>(buf_), len_),
-          serializer_(fastbuffer_)
+          fastbuffer_(reinterpret_cast<char*>(buffer_.get()), len_),
+          serializer_(fastbuffer_),
+          tail_(),
+          flatten_flag_()
     {
         serialize(header);
     }
 
-    ~OutputMessage()
-    {
-        delete[] buf_;
-    }
+    ~OutputMessage() = default;
 
     OutputMessage(OutputMessage&&) = delete;
     OutputMessage(const OutputMessage&) = delete;
     OutputMessage& operator=(OutputMessage&&) = delete;
     OutputMessage& operator=(const OutputMessage&) = delete;
 
-    uint8_t* get_buf() const { return buf_; }
+    /* Returns a buffer of at least len bytes from the smallest size class that fits it. */
+    static PooledBuffer acquire_buffer(size_t len);
+
+    /* Returns an empty vector to be filled with samples and carried as a scattered tail. */
+    static std::shared_ptr<std::vector<uint8_t>> acquire_tail();
+
+    /* Whole message in a single buffer, a scattered message is flattened on first use. */
+    uint8_t* get_buf() const;
+
+    size_t get_len() const { return get_head_len() + get_tail_len(); }
+
+    const uint8_t* get_head() const { return buffer_.get(); }
+
+    size_t get_head_len() const { return serializer_.getSerializedDataLength(); }
+
+    const uint8_t* get_tail() const { return tail_ ? tail_->data() : nullptr; }
+
+    size_t get_tail_len() const { return tail_ ? tail_->size() : 0; }
 
-    size_t get_len() const { return serializer_.getSerializedDataLength(); }
+    /* Whether a submessage can still be appended, a failed append leaves the message unusable. */
+    template<class T>
+    bool fits_submessage(
+            const T& data) const;
 
     template<class T>
     bool append_submessage(
@@ -59,6 +123,12 @@ public:
             const T& data,
             uint8_t flags = 0x01);
 
+    template<class T>
+    bool append_submessage(
+            dds::xrce::SubmessageId submessage_id,
+            const ScatteredSubmessage<T>& data,
+            uint8_t flags = 0x01);
+
     bool append_raw_payload(
             dds::xrce::SubmessageId submessage_id,
             const uint8_t* buf,
@@ -76,18 +146,45 @@ private:
             uint8_t flags,
             size_t submessage_len);
 
+    void align_submessage();
+
+    void clear(size_t size);
+
     template<class T>
     bool serialize(const T& data);
 
     void log_error();
 
 private:
-    uint8_t* buf_;
+    PooledBuffer buffer_;
     size_t len_;
     fastcdr::FastBuffer fastbuffer_;
     fastcdr::Cdr serializer_;
+    std::shared_ptr<const std::vector<uint8_t>> tail_;
+    mutable std::once_flag flatten_flag_;
 };
 
+inline uint8_t* OutputMessage::get_buf() const
+{
+    if (tail_)
+    {
+        std::call_once(flatten_flag_, [this]()
+        {
+            memcpy(buffer_.get() + get_head_len(), tail_->data(), tail_->size());
+        });
+    }
+    return buffer_.get();
+}
+
+template<class T>
+inline bool OutputMessage::fits_submessage(
+        const T& data) const
+{
+    /* Submessages are 4-byte aligned and start with a 4-byte subheader. */
+    const size_t offset = ((get_head_len() + 3) & ~size_t(3)) + 4;
+    return !tail_ && ((offset + data.getCdrSerializedSize(offset)) <= len_);
+}
+
 template<class T>
 inline bool OutputMessage::append_submessage(
         dds::xrce::SubmessageId submessage_id,
@@ -97,11 +194,32 @@ inline bool OutputMessage::append_submessage(
     bool rv = false;
     if (append_subheader(submessage_id, flags, data.getCdrSerializedSize()))
     {
+        /* Pooled buffers are not zero-filled, clear the CDR alignment gaps before serializing. */
+        clear(data.getCdrSerializedSize(get_head_len()));
         rv = serialize(data);
     }
     return rv;
 }
 
+template<class T>
+inline bool OutputMessage::append_submessage(
+        dds::xrce::SubmessageId submessage_id,
+        const ScatteredSubmessage<T>& data,
+        uint8_t flags)
+{
+    bool rv = false;
+    if (append_subheader(submessage_id, flags, data.getCdrSerializedSize()))
+    {
+        clear(data.head.getCdrSerializedSize(get_head_len()));
+        if (serialize(data.head) && (get_head_len() + data.tail->size() <= len_))
+        {
+            tail_ = data.tail;
+            rv = true;
+        }
+    }
+    return rv;
+}
+
 inline bool OutputMessage::append_raw_payload(
         dds::xrce::SubmessageId submessage_id,
         const uint8_t* buf,
@@ -134,7 +252,12 @@ inline bool OutputMessage::append_fragment(
         size_t len)
 {
     bool rv = false;
-    serializer_.jump((4 - ((serializer_.getCurrentPosition() - serializer_.getBufferPointer()) & 3)) & 3);
+    if (tail_)
+    {
+        return rv;
+    }
+
+    align_submessage();
     if (serialize(subheader))
     {
         try
@@ -161,10 +284,28 @@ inline bool OutputMessage::append_subheader(
     subheader.flags(flags);
     subheader.submessage_length(uint16_t(submessage_len));
 
-    serializer_.jump((4 - ((serializer_.getCurrentPosition() - serializer_.getBufferPointer()) & 3)) & 3);
+    /* A scattered tail always closes the message. */
+    if (tail_)
+    {
+        return false;
+    }
+
+    align_submessage();
     return serialize(subheader);
 }
 
+inline void OutputMessage::align_submessage()
+{
+    size_t padding = (4 - ((serializer_.getCurrentPosition() - serializer_.getBufferPointer()) & 3)) & 3;
+    clear(padding);
+    serializer_.jump(padding);
+}
+
+inline void OutputMessage::clear(size_t size)
+{
+    memset(serializer_.getCurrentPosition(), 0, std::min(size, len_ - get_head_len()));
+}
+
 template<class T>
 inline bool OutputMessage::serialize(const T& data)
 {
@@ -31,6 +31,14 @@ struct InputPacket
     InputMessagePtr message;
 };
 
+/* Output packets are sent by priority, lower values first. */
+enum OutputPriority : uint8_t
+{
+    CONTROL_OUTPUT_PRIORITY = 0,
+    DATA_OUTPUT_PRIORITY = 1,
+    OUTPUT_PRIORITY_LEVELS
+};
+
 typedef std::shared_ptr<OutputMessage> OutputMessagePtr;
 struct OutputPacket
 {
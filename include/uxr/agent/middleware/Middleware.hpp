@@ -16,6 +16,7 @@
 #define UXR_AGENT_MIDDLEWARE_MIDDLEWARE_HPP_
 
 #include <uxr/agent/config.hpp>
+#include <uxr/agent/types/ByteView.hpp>
 
 #include <string>
 #include <cstdint>
@@ -42,6 +43,12 @@ public:
     #endif
     };
 
+    /* Called from a middleware thread when a DataReader may have new data to read. */
+    typedef std::function<void ()> OnDataAvailable;
+
+    /* Called with a sample lent by the middleware, whose bytes are only valid until it returns. */
+    typedef std::function<void (const ByteView&)> OnDataLoan;
+
     Middleware() = default;
     virtual ~Middleware() = default;
 
@@ -120,15 +127,31 @@ public:
 /**********************************************************************************************************************
  * Write/Read functions.
  **********************************************************************************************************************/
+    /* The data points into the received message, it must be copied to be kept after the call. */
     virtual bool write_data(
             uint16_t datawriter_id,
-            const std::vector<uint8_t>& data) = 0;
+            const ByteView& data) = 0;
+
+    /* Samples received together, written in order. */
+    virtual bool write_data_batch(
+            uint16_t datawriter_id,
+            const std::vector<ByteView>& batch) = 0;
 
     virtual bool read_data(
             uint16_t datareader_id,
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout) = 0;
 
+    /* Non-blocking read which lends the next sample from the middleware's buffer instead of copying it. */
+    virtual bool loan_data(
+            uint16_t datareader_id,
+            const OnDataLoan& on_loan) = 0;
+
+    /* Once it returns, the previous callback is no longer running nor going to be called. */
+    virtual bool set_on_data_available(
+            uint16_t datareader_id,
+            OnDataAvailable on_data_available) = 0;
+
 /**********************************************************************************************************************
  * Matched functions.
  **********************************************************************************************************************/
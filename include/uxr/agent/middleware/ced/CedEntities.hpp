@@ -15,6 +15,7 @@
 #ifndef UXR_AGENT_MIDDLEWARE_CED_CED_ENTITIES_HPP_
 #define UXR_AGENT_MIDDLEWARE_CED_CED_ENTITIES_HPP_
 
+#include <uxr/agent/middleware/Middleware.hpp>
 #include <uxr/agent/utils/SeqNum.hpp>
 
 #include <string>
@@ -62,6 +63,7 @@ enum class ReadAccess : uint8_t
  * CedTopicManager
  **********************************************************************************************************************/
 class CedGlobalTopic;
+class CedDataReader;
 typedef const std::function<void (int16_t)> OnNewDomain;
 typedef const std::function<void (int16_t, const std::string&)> OnNewTopic;
 
@@ -121,13 +123,22 @@ public:
 
 private:
     bool write(
-            const std::vector<uint8_t>& data,
+            const ByteView& data,
             WriteAccess write_access,
             TopicSource topic_src,
             uint8_t& errcode);
 
+    bool write_batch(
+            const std::vector<ByteView>& batch,
+            WriteAccess write_access,
+            TopicSource topic_src,
+            uint8_t& errcode);
+
+    void notify_listeners();
+
+    /* The data is lent to on_loan under the topic lock. */
     bool read(
-            std::vector<uint8_t>& data,
+            const Middleware::OnDataLoan& on_loan,
             std::chrono::milliseconds timeout,
             SeqNum& last_read,
             ReadAccess read_access,
@@ -142,10 +153,14 @@ private:
             size_t index);
 
     bool get_data(
-            std::vector<uint8_t>& data,
+            const Middleware::OnDataLoan& on_loan,
             SeqNum& last_read,
             ReadAccess read_access);
 
+    void set_listener(
+            const CedDataReader* datareader,
+            Middleware::OnDataAvailable on_data_available);
+
 private:
     const std::string name_;
     int16_t domain_id_;
@@ -154,6 +169,8 @@ private:
     std::condition_variable cv_;
     std::array<std::vector<uint8_t>, 16> history_; // TODO (review history size)
     std::array<TopicSource, 16> srcs_; // TODO (review history size)
+    std::mutex listeners_mtx_;
+    std::unordered_map<const CedDataReader*, Middleware::OnDataAvailable> listeners_;
 };
 
 /**********************************************************************************************************************
@@ -263,7 +280,11 @@ public:
     ~CedDataWriter() = default;
 
     bool write(
-        const std::vector<uint8_t>& data,
+        const ByteView& data,
+        uint8_t& errcode) const;
+
+    bool write_batch(
+        const std::vector<ByteView>& batch,
         uint8_t& errcode) const;
 
     const std::string& topic_name() const { return topic_->global_topic()->name(); }
@@ -290,13 +311,19 @@ public:
         , last_read_(UINT16_MAX)
         , read_access_(read_access)
     {}
-    ~CedDataReader() = default;
+    ~CedDataReader();
 
     bool read(
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout,
             uint8_t& errcode);
 
+    bool loan(
+            const Middleware::OnDataLoan& on_loan,
+            uint8_t& errcode);
+
+    void set_on_data_available(Middleware::OnDataAvailable on_data_available);
+
     const std::string& topic_name() const { return topic_->global_topic()->name(); }
 
 private:
@@ -243,7 +243,18 @@ public:
      */
     bool write_data(
             uint16_t datawriter_id,
-            const std::vector<uint8_t>& data) override;
+            const ByteView& data) override;
+
+    /**
+     * @brief Writes several data using the CedDataWriter identified by the datawriter_id parameter.
+     *        The readers are notified once, after the whole batch is in the topic history.
+     * @param datawriter_id The CedDataWriter identifier.
+     * @param batch         The data to be written, in order.
+     * @return  true in case of successful writing and false in other case.
+     */
+    bool write_data_batch(
+            uint16_t datawriter_id,
+            const std::vector<ByteView>& batch) override;
 
     /**
      * @brief Read data using the CedDataReader identified by the datareader_id paramenter.
@@ -258,6 +269,28 @@ public:
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout) override;
 
+    /**
+     * @brief Lends the next data of the CedDataReader identified by the datareader_id parameter,
+     *        straight from the topic history. This function does not block.
+     * @param datareader_id The CedDataReader's identifier.
+     * @param on_loan       The callback which receives the data, valid until it returns.
+     * @return  true in case of successful reading and false in other case.
+     */
+    bool loan_data(
+            uint16_t datareader_id,
+            const OnDataLoan& on_loan) override;
+
+    /**
+     * @brief Sets the callback invoked whenever data is written into the topic of the CedDataReader
+     *        identified by the datareader_id parameter.
+     * @param datareader_id     The CedDataReader's identifier.
+     * @param on_data_available The callback, an empty one removes the previous callback.
+     * @return  true in case of the CedDataReader was found, false in other case.
+     */
+    bool set_on_data_available(
+            uint16_t datareader_id,
+            OnDataAvailable on_data_available) override;
+
     /**
      * @brief Checks whether an existing CedParticipant, identified by the participant_id, matches with a new
      *        CedParticipant that would result from the creation of a new one using the domain_id and the reference
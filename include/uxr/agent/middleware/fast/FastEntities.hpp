@@ -162,7 +162,7 @@ public:
 
     bool match_from_xml(const std::string& xml) const;
 
-    bool write(const std::vector<uint8_t>& data);
+    bool write(const ByteView& data);
 
     void onPublicationMatched(
             fastrtps::Publisher*,
@@ -201,6 +201,10 @@ public:
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout);
 
+    bool loan(const Middleware::OnDataLoan& on_loan);
+
+    void set_on_data_available(Middleware::OnDataAvailable on_data_available);
+
     void onSubscriptionMatched(
             fastrtps::Subscriber* sub,
             fastrtps::rtps::MatchingInfo& info) override;
@@ -215,6 +219,7 @@ private:
     std::mutex mtx_;
     std::condition_variable cv_;
     std::atomic<uint64_t> unread_count_;
+    Middleware::OnDataAvailable on_data_available_;
 };
 
 
@@ -111,13 +111,25 @@ public:
  **********************************************************************************************************************/
     bool write_data(
             uint16_t datawriter_id,
-            const std::vector<uint8_t>& data) override;
+            const ByteView& data) override;
+
+    bool write_data_batch(
+            uint16_t datawriter_id,
+            const std::vector<ByteView>& batch) override;
 
     bool read_data(
             uint16_t datareader_id,
             std::vector<uint8_t>& data,
             std::chrono::milliseconds timeout) override;
 
+    bool loan_data(
+            uint16_t datareader_id,
+            const OnDataLoan& on_loan) override;
+
+    bool set_on_data_available(
+            uint16_t datareader_id,
+            OnDataAvailable on_data_available) override;
+
 /**********************************************************************************************************************
  * Matched functions.
  **********************************************************************************************************************/
@@ -0,0 +1,130 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_OBJECT_OBJECT_TABLE_HPP_
+#define UXR_AGENT_OBJECT_OBJECT_TABLE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Objects of one kind indexed by the 12-bit raw id of their ObjectId, so the data path finds them
+ * without hashing nor casting. Entries are set and cleared by the owner of the objects under its own lock,
+ * lookups may run concurrently with them without taking it. Entries are loaded and stored with the
+ * shared_ptr atomics, which are not lock-free but only hold a short internal lock of the standard library.
+ * The table is split in chunks allocated on first use, which live as long as the table.
+ */
+template<class T>
+class ObjectTable
+{
+public:
+    ObjectTable()
+    {
+        for (auto& chunk : chunks_)
+        {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ObjectTable()
+    {
+        for (auto& chunk : chunks_)
+        {
+            delete chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    ObjectTable(ObjectTable&&) = delete;
+    ObjectTable(const ObjectTable&) = delete;
+    ObjectTable& operator=(ObjectTable&&) = delete;
+    ObjectTable& operator=(const ObjectTable&) = delete;
+
+    std::shared_ptr<T> get(uint16_t raw_id) const;
+
+    /* A null object clears the entry. */
+    void set(
+            uint16_t raw_id,
+            const std::shared_ptr<T>& object);
+
+    /* Clears the entries whose raw id satisfies the predicate. */
+    template<class F>
+    void remove_if(F&& predicate);
+
+private:
+    static constexpr size_t max_objects_ = 4096;
+    static constexpr size_t chunk_size_ = 64;
+
+    typedef std::array<std::shared_ptr<T>, chunk_size_> Chunk;
+
+    std::array<std::atomic<Chunk*>, max_objects_ / chunk_size_> chunks_;
+};
+
+template<class T>
+inline std::shared_ptr<T> ObjectTable<T>::get(uint16_t raw_id) const
+{
+    std::shared_ptr<T> rv;
+    const size_t index = raw_id & (max_objects_ - 1);
+    const Chunk* chunk = chunks_[index / chunk_size_].load(std::memory_order_acquire);
+    if (nullptr != chunk)
+    {
+        rv = std::atomic_load(&(*chunk)[index % chunk_size_]);
+    }
+    return rv;
+}
+
+template<class T>
+inline void ObjectTable<T>::set(
+        uint16_t raw_id,
+        const std::shared_ptr<T>& object)
+{
+    const size_t index = raw_id & (max_objects_ - 1);
+    Chunk* chunk = chunks_[index / chunk_size_].load(std::memory_order_acquire);
+    if ((nullptr == chunk) && object)
+    {
+        chunk = new Chunk();
+        chunks_[index / chunk_size_].store(chunk, std::memory_order_release);
+    }
+    if (nullptr != chunk)
+    {
+        std::atomic_store(&(*chunk)[index % chunk_size_], object);
+    }
+}
+
+template<class T>
+template<class F>
+inline void ObjectTable<T>::remove_if(F&& predicate)
+{
+    for (size_t i = 0; i < chunks_.size(); ++i)
+    {
+        Chunk* chunk = chunks_[i].load(std::memory_order_acquire);
+        for (size_t j = 0; (nullptr != chunk) && (j < chunk_size_); ++j)
+        {
+            if (std::atomic_load(&(*chunk)[j]) && predicate(uint16_t(i * chunk_size_ + j)))
+            {
+                std::atomic_store(&(*chunk)[j], std::shared_ptr<T>());
+            }
+        }
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_OBJECT_OBJECT_TABLE_HPP_
@@ -16,10 +16,15 @@
 #define UXR_AGENT_PROCESSOR_PROCESSOR_HPP_
 
 #include <uxr/agent/middleware/Middleware.hpp>
+#include <uxr/agent/utils/SeqNum.hpp>
+#include <uxr/agent/utils/TimerWheel.hpp>
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
 
 namespace dds {
 namespace xrce {
@@ -57,7 +62,21 @@ public:
             dds::xrce::TransportAddress& address,
             OutputPacket& output_packet) const;
 
-    void check_heartbeats();
+    /**
+     * Waits until a timer is due, or max_wait at most, and runs the due timers.
+     * Only reliable output streams with unacknowledged messages have a heartbeat timer,
+     * which runs with the retransmission timeout of the stream.
+     * Output streams holding an open coalesced message have a flush timer, which runs with the coalescing window.
+     */
+    void check_timers(
+            std::chrono::milliseconds max_wait);
+
+    /**
+     * Samples delivered within the window are packed in the same output message, up to the MTU.
+     * A zero window, the default, sends every sample in its own message.
+     */
+    void set_coalescing_window(
+            std::chrono::milliseconds window) { coalescing_window_ = window; }
 
 private:
     void process_input_message(
@@ -113,12 +132,44 @@ private:
 
     void read_data_callback(
             const ReadCallbackArgs& cb_args,
-            const std::vector<uint8_t>& buffer);
+            std::shared_ptr<const std::vector<uint8_t>> buffer);
+
+    void arm_heartbeat(
+            ProxyClient& client,
+            uint8_t stream_id);
+
+    void restart_heartbeat(
+            ProxyClient& client,
+            uint8_t stream_id);
+
+    void schedule_heartbeat(
+            const std::shared_ptr<ProxyClient>& client,
+            uint8_t stream_id,
+            std::chrono::milliseconds period);
+
+    void send_heartbeat(
+            const std::weak_ptr<ProxyClient>& client,
+            uint8_t stream_id);
+
+    void arm_flush(
+            ProxyClient& client,
+            uint8_t stream_id);
+
+    void flush_output(
+            const std::weak_ptr<ProxyClient>& client,
+            uint8_t stream_id,
+            SeqNum seq_num);
 
 private:
     Server& server_;
     Middleware::Kind middleware_kind_;
     Root& root_;
+    std::mutex timer_mtx_;
+    std::condition_variable timer_cv_;
+    utils::TimerWheel timers_;
+    utils::TimerWheel::Tick timer_wakeup_;
+    std::vector<utils::TimerWheel::Callback> expired_timers_;
+    std::chrono::milliseconds coalescing_window_;
 };
 
 } // namespace uxr
@@ -49,6 +49,19 @@ public:
     bool pop(
             T& element) final;
 
+    void push_batch(
+            std::vector<T>& elements,
+            uint8_t priority) final;
+
+    bool pop_batch(
+            std::vector<T>& elements,
+            size_t max_elements) final;
+
+private:
+    void push_element(
+            T&& element,
+            std::unique_lock<std::mutex>& lock);
+
 private:
     std::queue<T> queue_;
     std::mutex mtx_;
@@ -69,7 +82,7 @@ inline void FCFSScheduler<T>::deinit()
 {
     std::lock_guard<std::mutex> lock(mtx_);
     running_cond_ = false;
-    cond_var_.notify_one();
+    cond_var_.notify_all();
 }
 
 template<class T>
@@ -78,12 +91,23 @@ inline void FCFSScheduler<T>::push(
         uint8_t priority)
 {
     (void) priority;
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (max_size_ <= queue_.size())
+    std::unique_lock<std::mutex> lock(mtx_);
+    push_element(std::move(element), lock);
+    cond_var_.notify_one();
+}
+
+template<class T>
+inline void FCFSScheduler<T>::push_batch(
+        std::vector<T>& elements,
+        uint8_t priority)
+{
+    (void) priority;
+    std::unique_lock<std::mutex> lock(mtx_);
+    for (auto& element : elements)
     {
-        queue_.pop();
+        push_element(std::move(element), lock);
     }
-    queue_.push(std::move(element));
+    elements.clear();
     cond_var_.notify_one();
 }
 
@@ -96,14 +120,81 @@ inline bool FCFSScheduler<T>::pop(
     cond_var_.wait(lock, [this] { return !(queue_.empty() && running_cond_); });
     if (running_cond_)
     {
+        bool was_full = (max_size_ <= queue_.size());
         element = std::move(queue_.front());
         queue_.pop();
         rv = true;
-        cond_var_.notify_one();
+        /* Producers blocked on a full queue share the condition variable with consumers. */
+        if (was_full)
+        {
+            cond_var_.notify_all();
+        }
+        else
+        {
+            cond_var_.notify_one();
+        }
+    }
+    return rv;
+}
+
+template<class T>
+inline bool FCFSScheduler<T>::pop_batch(
+        std::vector<T>& elements,
+        size_t max_elements)
+{
+    bool rv = false;
+    std::unique_lock<std::mutex> lock(mtx_);
+    cond_var_.wait(lock, [this] { return !(queue_.empty() && running_cond_); });
+    if (running_cond_)
+    {
+        while (!queue_.empty() && (elements.size() < max_elements))
+        {
+            elements.push_back(std::move(queue_.front()));
+            queue_.pop();
+        }
+        rv = true;
+        cond_var_.notify_all();
     }
     return rv;
 }
 
+template<class T>
+inline void FCFSScheduler<T>::push_element(
+        T&& element,
+        std::unique_lock<std::mutex>& lock)
+{
+    bool push = true;
+    if (max_size_ <= queue_.size())
+    {
+        switch (this->overflow_policy_)
+        {
+            case OverflowPolicy::DROP_OLDEST:
+                queue_.pop();
+                ++this->dropped_;
+                break;
+            case OverflowPolicy::DROP_NEWEST:
+                push = false;
+                break;
+            case OverflowPolicy::BLOCK:
+                /* Wake the consumers up before blocking, the batch is only notified once it is complete. */
+                cond_var_.notify_all();
+                push = cond_var_.wait_for(lock, this->block_timeout_,
+                                          [this] { return (max_size_ > queue_.size()) || !running_cond_; })
+                       && running_cond_;
+                break;
+        }
+    }
+
+    if (push)
+    {
+        queue_.push(std::move(element));
+    }
+    else
+    {
+        ++this->dropped_;
+    }
+}
+
 } // namespace uxr
 } // namespace eprosima
 
@@ -0,0 +1,249 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_SCHEDULER_PRIORITY_SCHEDULER_HPP_
+#define UXR_AGENT_SCHEDULER_PRIORITY_SCHEDULER_HPP_
+
+#include <uxr/agent/scheduler/Scheduler.hpp>
+
+#include <queue>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Scheduler with one FIFO lane per priority level, where 0 is the highest priority.
+ * Elements are always popped from the highest priority non-empty lane, and under the drop-oldest
+ * overflow policy the element dropped is the oldest one of the lowest priority non-empty lane.
+ */
+template<class T>
+class PriorityScheduler : public Scheduler<T>
+{
+public:
+    PriorityScheduler(
+            size_t max_size,
+            uint8_t levels)
+        : lanes_((0 < levels) ? levels : 1)
+        , size_{0}
+        , mtx_()
+        , cond_var_()
+        , running_cond_(false)
+        , max_size_{max_size}
+    {}
+
+    void init() final;
+
+    void deinit() final;
+
+    void set_max_size(
+            size_t max_size);
+
+    void push(
+            T&& element,
+            uint8_t priority) final;
+
+    bool pop(
+            T& element) final;
+
+    void push_batch(
+            std::vector<T>& elements,
+            uint8_t priority) final;
+
+    bool pop_batch(
+            std::vector<T>& elements,
+            size_t max_elements) final;
+
+private:
+    void push_element(
+            T&& element,
+            uint8_t priority,
+            std::unique_lock<std::mutex>& lock);
+
+    void pop_element(
+            T& element);
+
+private:
+    std::vector<std::queue<T>> lanes_;
+    size_t size_;
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+    bool running_cond_;
+    size_t max_size_;
+};
+
+template<class T>
+inline void PriorityScheduler<T>::init()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    running_cond_ = true;
+}
+
+template<class T>
+inline void PriorityScheduler<T>::set_max_size(
+        size_t max_size)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    max_size_ = max_size;
+}
+
+template<class T>
+inline void PriorityScheduler<T>::deinit()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    running_cond_ = false;
+    cond_var_.notify_all();
+}
+
+template<class T>
+inline void PriorityScheduler<T>::push(
+        T&& element,
+        uint8_t priority)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    push_element(std::move(element), priority, lock);
+    cond_var_.notify_one();
+}
+
+template<class T>
+inline void PriorityScheduler<T>::push_batch(
+        std::vector<T>& elements,
+        uint8_t priority)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    for (auto& element : elements)
+    {
+        push_element(std::move(element), priority, lock);
+    }
+    elements.clear();
+    cond_var_.notify_one();
+}
+
+template<class T>
+inline bool PriorityScheduler<T>::pop(
+        T& element)
+{
+    bool rv = false;
+    std::unique_lock<std::mutex> lock(mtx_);
+    cond_var_.wait(lock, [this] { return !((0 == size_) && running_cond_); });
+    if (running_cond_)
+    {
+        bool was_full = (max_size_ <= size_);
+        pop_element(element);
+        rv = true;
+        /* Producers blocked on a full queue share the condition variable with consumers. */
+        if (was_full)
+        {
+            cond_var_.notify_all();
+        }
+        else
+        {
+            cond_var_.notify_one();
+        }
+    }
+    return rv;
+}
+
+template<class T>
+inline bool PriorityScheduler<T>::pop_batch(
+        std::vector<T>& elements,
+        size_t max_elements)
+{
+    bool rv = false;
+    std::unique_lock<std::mutex> lock(mtx_);
+    cond_var_.wait(lock, [this] { return !((0 == size_) && running_cond_); });
+    if (running_cond_)
+    {
+        T element;
+        while ((0 != size_) && (elements.size() < max_elements))
+        {
+            pop_element(element);
+            elements.push_back(std::move(element));
+        }
+        rv = true;
+        cond_var_.notify_all();
+    }
+    return rv;
+}
+
+template<class T>
+inline void PriorityScheduler<T>::push_element(
+        T&& element,
+        uint8_t priority,
+        std::unique_lock<std::mutex>& lock)
+{
+    bool push = true;
+    if (max_size_ <= size_)
+    {
+        switch (this->overflow_policy_)
+        {
+            case OverflowPolicy::DROP_OLDEST:
+                for (auto it = lanes_.rbegin(); it != lanes_.rend(); ++it)
+                {
+                    if (!it->empty())
+                    {
+                        it->pop();
+                        --size_;
+                        break;
+                    }
+                }
+                ++this->dropped_;
+                break;
+            case OverflowPolicy::DROP_NEWEST:
+                push = false;
+                break;
+            case OverflowPolicy::BLOCK:
+                /* Wake the consumers up before blocking, the batch is only notified once it is complete. */
+                cond_var_.notify_all();
+                push = cond_var_.wait_for(lock, this->block_timeout_,
+                                          [this] { return (max_size_ > size_) || !running_cond_; })
+                       && running_cond_;
+                break;
+        }
+    }
+
+    if (push)
+    {
+        size_t lane = (priority < lanes_.size()) ? priority : lanes_.size() - 1;
+        lanes_[lane].push(std::move(element));
+        ++size_;
+    }
+    else
+    {
+        ++this->dropped_;
+    }
+}
+
+template<class T>
+inline void PriorityScheduler<T>::pop_element(
+        T& element)
+{
+    for (auto& lane : lanes_)
+    {
+        if (!lane.empty())
+        {
+            element = std::move(lane.front());
+            lane.pop();
+            --size_;
+            break;
+        }
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_SCHEDULER_PRIORITY_SCHEDULER_HPP_
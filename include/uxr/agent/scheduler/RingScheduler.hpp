@@ -0,0 +1,274 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_SCHEDULER_RING_SCHEDULER_HPP_
+#define UXR_AGENT_SCHEDULER_RING_SCHEDULER_HPP_
+
+#include <uxr/agent/scheduler/Scheduler.hpp>
+#include <uxr/agent/utils/LockFreeQueue.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Bounded lock-free scheduler on top of a utils::LockFreeQueue.
+ * Consumers spin for a while when the ring is empty and then park on a condition variable,
+ * which producers only touch when there is someone parked. A producer blocked by a full ring
+ * parks on its own condition variable, which consumers only touch when there is someone blocked,
+ * until there is room or its timeout expires.
+ */
+template<class T>
+class RingScheduler : public Scheduler<T>
+{
+public:
+    RingScheduler(
+            size_t max_size)
+        : queue_{max_size}
+        , running_cond_{false}
+        , sleepers_{0}
+        , blocked_{0}
+        , mtx_()
+        , cond_var_()
+        , room_cond_var_()
+    {}
+
+    void init() final;
+
+    void deinit() final;
+
+    void push(
+            T&& element,
+            uint8_t priority) final;
+
+    bool pop(
+            T& element) final;
+
+    void push_batch(
+            std::vector<T>& elements,
+            uint8_t priority) final;
+
+    bool pop_batch(
+            std::vector<T>& elements,
+            size_t max_elements) final;
+
+    size_t capacity() const { return queue_.capacity(); }
+
+private:
+    void push_element(T& element);
+
+    bool wait_element();
+
+    void wake_up();
+
+    void wake_up_blocked();
+
+private:
+    static constexpr int SPIN_COUNT = 256;
+
+    utils::LockFreeQueue<T> queue_;
+    std::atomic<bool> running_cond_;
+    std::atomic<size_t> sleepers_;
+    std::atomic<size_t> blocked_;
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+    std::condition_variable room_cond_var_;
+};
+
+template<class T>
+inline void RingScheduler<T>::init()
+{
+    running_cond_ = true;
+}
+
+template<class T>
+inline void RingScheduler<T>::deinit()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    running_cond_ = false;
+    cond_var_.notify_all();
+    room_cond_var_.notify_all();
+}
+
+template<class T>
+inline void RingScheduler<T>::push(
+        T&& element,
+        uint8_t priority)
+{
+    (void) priority;
+    push_element(element);
+    wake_up();
+}
+
+template<class T>
+inline void RingScheduler<T>::push_batch(
+        std::vector<T>& elements,
+        uint8_t priority)
+{
+    (void) priority;
+    for (auto& element : elements)
+    {
+        push_element(element);
+    }
+    elements.clear();
+    wake_up();
+}
+
+template<class T>
+inline bool RingScheduler<T>::pop(
+        T& element)
+{
+    bool rv = false;
+    while (!rv && wait_element())
+    {
+        rv = queue_.try_pop(element);
+    }
+    if (rv)
+    {
+        wake_up_blocked();
+    }
+    return rv;
+}
+
+template<class T>
+inline bool RingScheduler<T>::pop_batch(
+        std::vector<T>& elements,
+        size_t max_elements)
+{
+    bool rv = false;
+    T element;
+    while (!rv && wait_element())
+    {
+        while ((elements.size() < max_elements) && queue_.try_pop(element))
+        {
+            elements.push_back(std::move(element));
+            rv = true;
+        }
+    }
+    if (rv)
+    {
+        wake_up_blocked();
+    }
+    return rv;
+}
+
+template<class T>
+inline void RingScheduler<T>::push_element(
+        T& element)
+{
+    if (queue_.try_push(element))
+    {
+        return;
+    }
+
+    bool pushed = false;
+    switch (this->overflow_policy_)
+    {
+        case OverflowPolicy::DROP_OLDEST:
+        {
+            T discarded;
+            while (!pushed)
+            {
+                if (queue_.try_pop(discarded))
+                {
+                    ++this->dropped_;
+                }
+                pushed = queue_.try_push(element);
+            }
+            break;
+        }
+        case OverflowPolicy::DROP_NEWEST:
+            break;
+        case OverflowPolicy::BLOCK:
+        {
+            /* Wake the consumers up before blocking, the batch is only notified once it is complete. */
+            wake_up();
+            std::unique_lock<std::mutex> lock(mtx_);
+            blocked_.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            room_cond_var_.wait_for(lock, this->block_timeout_, [&]()
+            {
+                pushed = running_cond_ && queue_.try_push(element);
+                return pushed || !running_cond_;
+            });
+            blocked_.fetch_sub(1);
+            break;
+        }
+    }
+
+    if (!pushed)
+    {
+        ++this->dropped_;
+    }
+}
+
+template<class T>
+inline bool RingScheduler<T>::wait_element()
+{
+    auto is_ready = [this]()
+    {
+        return !queue_.empty() || !running_cond_;
+    };
+
+    /* Spin. */
+    for (int i = 0; (i < SPIN_COUNT) && !is_ready(); ++i)
+    {
+        std::this_thread::yield();
+    }
+
+    /* Park. */
+    if (!is_ready())
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        sleepers_.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cond_var_.wait(lock, is_ready);
+        sleepers_.fetch_sub(1);
+    }
+
+    return running_cond_;
+}
+
+template<class T>
+inline void RingScheduler<T>::wake_up()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (0 != sleepers_.load())
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        cond_var_.notify_all();
+    }
+}
+
+template<class T>
+inline void RingScheduler<T>::wake_up_blocked()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (0 != blocked_.load())
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        room_cond_var_.notify_all();
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_SCHEDULER_RING_SCHEDULER_HPP_
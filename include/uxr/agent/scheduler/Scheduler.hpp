@@ -16,10 +16,28 @@
 #define _UXR_AGENT_SCHEDULER_SCHEDULER_HPP_
 
 #include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <chrono>
 
 namespace eprosima {
 namespace uxr {
 
+enum class SchedulerKind : uint8_t
+{
+    FCFS,
+    RING
+};
+
+/* What a full scheduler does with a new element. */
+enum class OverflowPolicy : uint8_t
+{
+    DROP_OLDEST,
+    DROP_NEWEST,
+    BLOCK
+};
+
 template<class T>
 class Scheduler
 {
@@ -27,10 +45,48 @@ public:
     Scheduler() = default;
     virtual ~Scheduler() {}
 
+    /* Must be called before init(), block_timeout only applies to OverflowPolicy::BLOCK. */
+    void set_overflow_policy(OverflowPolicy overflow_policy, std::chrono::milliseconds block_timeout)
+    {
+        overflow_policy_ = overflow_policy;
+        block_timeout_ = block_timeout;
+    }
+
+    /* Number of elements discarded because the scheduler was full. */
+    uint64_t get_dropped() const { return dropped_; }
+
     virtual void init() = 0;
     virtual void deinit() = 0;
     virtual void push(T&& element, uint8_t priority) = 0;
     virtual bool pop(T& element) = 0;
+
+    /* Moves all the elements into the scheduler, leaving the vector empty. */
+    virtual void push_batch(std::vector<T>& elements, uint8_t priority)
+    {
+        for (auto& element : elements)
+        {
+            push(std::move(element), priority);
+        }
+        elements.clear();
+    }
+
+    /* Waits for at least one element and appends up to max_elements to the vector. */
+    virtual bool pop_batch(std::vector<T>& elements, size_t max_elements)
+    {
+        (void) max_elements;
+        T element;
+        bool rv = pop(element);
+        if (rv)
+        {
+            elements.push_back(std::move(element));
+        }
+        return rv;
+    }
+
+protected:
+    OverflowPolicy overflow_policy_ = OverflowPolicy::DROP_OLDEST;
+    std::chrono::milliseconds block_timeout_{0};
+    std::atomic<uint64_t> dropped_{0};
 };
 
 } // namespace uxr
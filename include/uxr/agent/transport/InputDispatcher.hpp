@@ -0,0 +1,123 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_TRANSPORT_INPUT_DISPATCHER_HPP_
+#define UXR_AGENT_TRANSPORT_INPUT_DISPATCHER_HPP_
+
+#include <uxr/agent/scheduler/Scheduler.hpp>
+#include <uxr/agent/message/Packet.hpp>
+#include <uxr/agent/message/InputMessage.hpp>
+#include <uxr/agent/transport/endpoint/EndPoint.hpp>
+#include <uxr/agent/utils/Conversion.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+typedef std::vector<std::unique_ptr<Scheduler<InputPacket>>> WorkerQueues;
+
+/**
+ * Routes input packets to the queues of the processing workers.
+ * Packets of the same client always go to the same worker to keep their ordering.
+ * Each receiver thread owns its dispatcher.
+ */
+class InputDispatcher
+{
+public:
+    explicit InputDispatcher(
+            WorkerQueues& worker_queues)
+        : worker_queues_(worker_queues)
+        , worker_batches_(worker_queues.size())
+    {}
+
+    ~InputDispatcher() = default;
+
+    InputDispatcher(InputDispatcher&&) = delete;
+    InputDispatcher(const InputDispatcher&) = delete;
+    InputDispatcher& operator=(InputDispatcher&&) = delete;
+    InputDispatcher& operator=(const InputDispatcher&) = delete;
+
+    /* Clients are told by their key, or by their source when the messages do not carry it. */
+    static size_t get_worker_id(
+            const InputPacket& input_packet,
+            size_t worker_count);
+
+    void push(InputPacket&& input_packet);
+
+    /* Moves all the packets into the worker queues, leaving the vector empty. */
+    void push_batch(std::vector<InputPacket>& input_packets);
+
+private:
+    WorkerQueues& worker_queues_;
+    std::vector<std::vector<InputPacket>> worker_batches_;
+};
+
+inline size_t InputDispatcher::get_worker_id(
+        const InputPacket& input_packet,
+        size_t worker_count)
+{
+    if (1 == worker_count)
+    {
+        return 0;
+    }
+
+    size_t hash;
+    const dds::xrce::MessageHeader& header = input_packet.message->get_header();
+    if (128 > header.session_id())
+    {
+        hash = conversion::clientkey_to_raw(header.client_key());
+    }
+    else
+    {
+        hash = input_packet.source->hash();
+    }
+    return hash % worker_count;
+}
+
+inline void InputDispatcher::push(InputPacket&& input_packet)
+{
+    const size_t worker_id = get_worker_id(input_packet, worker_queues_.size());
+    worker_queues_[worker_id]->push(std::move(input_packet), 0);
+}
+
+inline void InputDispatcher::push_batch(std::vector<InputPacket>& input_packets)
+{
+    if (1 == worker_queues_.size())
+    {
+        worker_queues_.front()->push_batch(input_packets, 0);
+    }
+    else
+    {
+        /* Split the batch per worker, each worker queue is locked once. */
+        for (auto& input_packet : input_packets)
+        {
+            worker_batches_[get_worker_id(input_packet, worker_queues_.size())].push_back(std::move(input_packet));
+        }
+        input_packets.clear();
+        for (size_t i = 0; i < worker_queues_.size(); ++i)
+        {
+            if (!worker_batches_[i].empty())
+            {
+                worker_queues_[i]->push_batch(worker_batches_[i], 0);
+            }
+        }
+    }
+}
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_TRANSPORT_INPUT_DISPATCHER_HPP_
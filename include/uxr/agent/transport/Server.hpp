@@ -17,11 +17,16 @@
 
 #include <uxr/agent/Agent.hpp>
 #include <uxr/agent/transport/endpoint/EndPoint.hpp>
-#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+#include <uxr/agent/scheduler/Scheduler.hpp>
+#include <uxr/agent/scheduler/PriorityScheduler.hpp>
 #include <uxr/agent/message/Packet.hpp>
 #include <uxr/agent/processor/Processor.hpp>
 
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
@@ -39,6 +44,30 @@ public:
     UXR_AGENT_EXPORT bool run();
     UXR_AGENT_EXPORT bool stop();
 
+    /* Must be called before run(). */
+    UXR_AGENT_EXPORT bool set_recv_batch_size(size_t batch_size);
+    UXR_AGENT_EXPORT bool set_send_batch_size(size_t batch_size);
+    UXR_AGENT_EXPORT bool set_worker_count(size_t worker_count);
+    UXR_AGENT_EXPORT bool set_scheduler_kind(SchedulerKind scheduler_kind);
+    UXR_AGENT_EXPORT bool set_queue_size(size_t queue_size);
+    UXR_AGENT_EXPORT bool set_stream_depths(
+            uint16_t best_effort_depth,
+            uint16_t reliable_depth);
+    UXR_AGENT_EXPORT bool set_input_overflow_policy(
+            OverflowPolicy overflow_policy,
+            std::chrono::milliseconds block_timeout = std::chrono::milliseconds(0));
+    UXR_AGENT_EXPORT bool set_output_overflow_policy(
+            OverflowPolicy overflow_policy,
+            std::chrono::milliseconds block_timeout = std::chrono::milliseconds(0));
+    UXR_AGENT_EXPORT bool set_coalescing_window(std::chrono::milliseconds window);
+
+    /* Packets handed to the input queues, the dropped ones included. */
+    UXR_AGENT_EXPORT uint64_t get_input_received() const;
+
+    /* Packets dropped because the queues were full. */
+    UXR_AGENT_EXPORT uint64_t get_input_dropped() const;
+    UXR_AGENT_EXPORT uint64_t get_output_dropped() const;
+
 #ifdef UAGENT_DISCOVERY_PROFILE
     UXR_AGENT_EXPORT bool enable_discovery(uint16_t discovery_port = DISCOVERY_PORT);
     UXR_AGENT_EXPORT bool disable_discovery();
@@ -50,7 +79,9 @@ public:
 #endif
 
 private:
-    void push_output_packet(OutputPacket output_packet);
+    void push_output_packet(
+            OutputPacket output_packet,
+            OutputPriority priority);
 
     virtual void on_create_client(
             EndPoint* source,
@@ -82,15 +113,27 @@ private:
             InputPacket& input_packet,
             int timeout) = 0;
 
+    /* Transports with several ingress sockets get one receiver thread per socket. */
+    virtual size_t get_receiver_count() const;
+
+    virtual bool recv_messages(
+            std::vector<InputPacket>& input_packets,
+            size_t max_packets,
+            int timeout,
+            size_t receiver_id);
+
     virtual bool send_message(OutputPacket output_packet) = 0;
 
+    /* Sends all the packets and leaves the vector empty. */
+    virtual bool send_messages(std::vector<OutputPacket>& output_packets);
+
     virtual int get_error() = 0;
 
-    void receiver_loop();
+    void receiver_loop(size_t receiver_id);
 
     void sender_loop();
 
-    void processing_loop();
+    void processing_loop(size_t worker_id);
 
     void heartbeat_loop();
 
@@ -99,13 +142,21 @@ protected:
 
 private:
     std::mutex mtx_;
-    std::thread receiver_thread_;
+    std::vector<std::thread> receiver_threads_;
     std::thread sender_thread_;
-    std::thread processing_thread_;
+    std::vector<std::thread> processing_threads_;
     std::thread heartbeat_thread_;
     std::atomic<bool> running_cond_;
-    FCFSScheduler<InputPacket> input_scheduler_;
-    FCFSScheduler<OutputPacket> output_scheduler_;
+    std::atomic<uint64_t> input_received_;
+    size_t recv_batch_size_;
+    size_t send_batch_size_;
+    size_t worker_count_;
+    size_t queue_size_;
+    SchedulerKind scheduler_kind_;
+    OverflowPolicy input_overflow_policy_;
+    std::chrono::milliseconds input_block_timeout_;
+    std::vector<std::unique_ptr<Scheduler<InputPacket>>> input_schedulers_;
+    PriorityScheduler<OutputPacket> output_scheduler_;
 };
 
 } // namespace uxr
@@ -16,6 +16,7 @@
 #define UXR_AGENT_TRANSPORT_ENDPOINT_ENDPOINT_HPP_
 
 #include <iostream>
+#include <cstddef>
 
 namespace eprosima {
 namespace uxr {
@@ -27,6 +28,8 @@ public:
     virtual ~EndPoint() = default;
 
     virtual std::ostream& print(std::ostream& os) const = 0;
+
+    virtual size_t hash() const = 0;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const EndPoint& endpoint)
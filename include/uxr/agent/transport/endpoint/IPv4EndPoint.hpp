@@ -27,9 +27,11 @@ class IPv4EndPoint : public EndPoint
 public:
     IPv4EndPoint(
             uint32_t addr,
-            uint16_t port)
+            uint16_t port,
+            uint16_t socket_id = 0)
         : addr_(addr)
         , port_(port)
+        , socket_id_(socket_id)
     {}
 
     ~IPv4EndPoint() final = default;
@@ -44,12 +46,21 @@ public:
         return os;
     }
 
+    size_t hash() const final
+    {
+        return size_t((uint64_t(addr_) << 16) | port_);
+    }
+
     uint32_t get_addr() const { return addr_; }
     uint16_t get_port() const { return port_; }
 
+    /* Agent socket the endpoint was reached through, when the server listens on several. */
+    uint16_t get_socket_id() const { return socket_id_; }
+
 private:
     uint32_t addr_;
     uint16_t port_;
+    uint16_t socket_id_;
 };
 
 } // namespace uxr
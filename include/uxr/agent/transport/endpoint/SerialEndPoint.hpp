@@ -34,6 +34,11 @@ public:
         return os << int(addr_);
     }
 
+    size_t hash() const final
+    {
+        return size_t(addr_);
+    }
+
     uint8_t get_addr() const { return addr_; }
 
 public:
@@ -24,10 +24,9 @@
 #endif
 #include <uxr/agent/config.hpp>
 #include <netinet/in.h>
-#include <sys/poll.h>
-#include <array>
-#include <list>
-#include <set>
+#include <memory>
+#include <queue>
+#include <unordered_map>
 
 namespace eprosima {
 namespace uxr {
@@ -39,7 +38,8 @@ public:
     ~TCPConnectionPlatform() final = default;
 
 public:
-    struct pollfd* poll_fd;
+    int fd;
+    std::shared_ptr<EndPoint> endpoint;
 };
 
 class TCPv4Agent : public TCPServerBase
@@ -72,19 +72,27 @@ private:
             InputPacket& input_packet,
             int timeout) final;
 
+    bool recv_messages(
+            std::vector<InputPacket>& input_packets,
+            size_t max_packets,
+            int timeout,
+            size_t receiver_id) final;
+
     bool send_message(OutputPacket output_packet) final;
 
     int get_error() final;
 
     bool read_message(int timeout);
 
+    void accept_connections();
+
+    void read_connection(uint32_t connection_id);
+
     bool open_connection(
             int fd,
             struct sockaddr_in* sockaddr);
 
-    bool connection_available();
-
-    void listener_loop();
+    std::shared_ptr<TCPConnectionPlatform> get_connection(uint32_t connection_id);
 
     static void init_input_buffer(TCPInputBuffer& buffer);
 
@@ -105,15 +113,11 @@ private:
             uint8_t& errcode) override;
 
 private:
-    std::array<TCPConnectionPlatform, TCP_MAX_CONNECTIONS> connections_;
-    std::set<uint32_t> active_connections_;
-    std::list<uint32_t> free_connections_;
+    std::unordered_map<uint32_t, std::shared_ptr<TCPConnectionPlatform>> connections_;
+    uint32_t next_connection_id_;
     std::mutex connections_mtx_;
-    struct pollfd listener_poll_;
-    std::array<struct pollfd, TCP_MAX_CONNECTIONS> poll_fds_;
-    uint8_t buffer_[UINT16_MAX];
-    std::thread listener_thread_;
-    std::atomic<bool> running_cond_;
+    int listener_fd_;
+    int epoll_fd_;
     std::queue<InputPacket> messages_queue_;
 #ifdef UAGENT_DISCOVERY_PROFILE
     DiscoveryServerLinux discovery_server_;
@@ -47,7 +47,7 @@ protected:
 
 private:
     std::unordered_map<uint64_t, uint32_t> source_to_client_map_;
-    std::unordered_map<uint32_t, uint64_t> client_to_source_map_;
+    std::unordered_map<uint32_t, IPv4EndPoint> client_to_source_map_;
     std::mutex clients_mtx_;
 };
 
@@ -25,8 +25,12 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <memory>
 #include <sys/poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 #include <unordered_map>
+#include <vector>
 
 namespace eprosima {
 namespace uxr {
@@ -40,6 +44,9 @@ public:
 
     ~UDPv4Agent() final;
 
+    /* Must be called before run(), more than one socket binds the port with SO_REUSEPORT. */
+    UXR_AGENT_EXPORT bool set_socket_count(size_t socket_count);
+
 private:
     bool init() final;
 
@@ -61,14 +68,63 @@ private:
             InputPacket& input_packet,
             int timeout) final;
 
+    size_t get_receiver_count() const final;
+
+    bool recv_messages(
+            std::vector<InputPacket>& input_packets,
+            size_t max_packets,
+            int timeout,
+            size_t receiver_id) final;
+
     bool send_message(OutputPacket output_packet) final;
 
+    bool send_messages(std::vector<OutputPacket>& output_packets) final;
+
     int get_error() final;
 
+    struct Socket;
+
+    bool open_socket(Socket& socket);
+
+    void fill_input_packet(
+            Socket& socket,
+            InputPacket& input_packet,
+            PooledBuffer&& slab,
+            const uint8_t* overflow,
+            size_t len,
+            const struct sockaddr_in& client_addr);
+
+    const std::shared_ptr<EndPoint>& get_endpoint(
+            Socket& socket,
+            const struct sockaddr_in& client_addr);
+
+    int get_socket_fd(const OutputPacket& output_packet) const;
+
+    static size_t fill_iovecs(
+            const OutputMessage& output_message,
+            struct iovec* iovecs);
+
 private:
-    struct pollfd poll_fd_;
+    /* Receiving state of a socket, only touched by the receiver thread serving it. */
+    struct Socket
+    {
+        uint16_t id;
+        struct pollfd poll_fd;
+        std::unordered_map<uint64_t, std::shared_ptr<EndPoint>> endpoints;
+        std::vector<struct mmsghdr> mmsg_headers;
+        std::vector<struct iovec> mmsg_iovecs;
+        std::vector<struct sockaddr_in> mmsg_addrs;
+        std::vector<PooledBuffer> mmsg_slabs;
+        std::unique_ptr<uint8_t[]> mmsg_overflows;
+    };
+
+    size_t socket_count_;
+    std::vector<std::unique_ptr<Socket>> sockets_;
     uint8_t buffer_[UINT16_MAX];
     uint16_t port_;
+    std::vector<struct mmsghdr> send_headers_;
+    std::vector<struct iovec> send_iovecs_;
+    std::vector<struct sockaddr_in> send_addrs_;
 #ifdef UAGENT_DISCOVERY_PROFILE
     DiscoveryServerLinux discovery_server_;
 #endif
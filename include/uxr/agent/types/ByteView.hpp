@@ -0,0 +1,69 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_TYPES_BYTE_VIEW_HPP_
+#define UXR_AGENT_TYPES_BYTE_VIEW_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+
+/**
+ * Non-owning view of a sample, usually pointing into the buffer of the message it was received in.
+ * The bytes are only valid while that buffer lives, whoever keeps the sample must copy them.
+ */
+class ByteView
+{
+public:
+    ByteView()
+        : data_(nullptr)
+        , size_(0)
+    {}
+
+    ByteView(
+            const uint8_t* data,
+            size_t size)
+        : data_(data)
+        , size_(size)
+    {}
+
+    ByteView(const std::vector<uint8_t>& data)
+        : data_(data.data())
+        , size_(data.size())
+    {}
+
+    const uint8_t* data() const { return data_; }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return 0 == size_; }
+
+    const uint8_t* begin() const { return data_; }
+
+    const uint8_t* end() const { return data_ + size_; }
+
+    std::vector<uint8_t> to_vector() const { return std::vector<uint8_t>(begin(), end()); }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_TYPES_BYTE_VIEW_HPP_
@@ -15,19 +15,26 @@
 #ifndef _UXR_AGENT_TYPES_TOPICPUBSUBTYPES_HPP_
 #define _UXR_AGENT_TYPES_TOPICPUBSUBTYPES_HPP_
 
+#include <uxr/agent/middleware/Middleware.hpp>
 #include <fastrtps/TopicDataType.h>
 
-#include <vector>
-
 using namespace eprosima::fastrtps;
 namespace eprosima {
 namespace uxr {
 
+/**
+ * Data handed to Fast-RTPS for both directions, so that every object it gets is of the same type.
+ * A sample is written from its view and read by lending the payload to its callback, when it has one.
+ */
+struct TopicSample
+{
+    ByteView view;
+    const Middleware::OnDataLoan* on_loan;
+};
+
 class TopicPubSubType: public TopicDataType
 {
 public:
-    typedef std::vector<unsigned char> type;
-
     explicit TopicPubSubType(bool with_key);
     ~TopicPubSubType() override = default;
     bool serialize(void* data, rtps::SerializedPayload_t* payload) override;
@@ -190,6 +190,231 @@ protected:
     CLI::Option* cli_opt_;
 };
 
+/*************************************************************************************************
+ * Receive Batch CLI Option
+ *************************************************************************************************/
+class RecvBatchOpt
+{
+public:
+    RecvBatchOpt(CLI::App& subcommand)
+        : size_{1}
+        , cli_opt_{subcommand.add_option("--recv-batch", size_, "Select the maximum number of datagrams read per call", true)}
+    {
+        cli_opt_->check(CLI::Range(1, 1024));
+    }
+
+    bool is_enable() const { return bool(*cli_opt_); }
+    uint16_t get_size() const { return size_; }
+
+protected:
+    uint16_t size_;
+    CLI::Option* cli_opt_;
+};
+
+#ifndef _WIN32
+/*************************************************************************************************
+ * Sockets CLI Option
+ *************************************************************************************************/
+class SocketsOpt
+{
+public:
+    SocketsOpt(CLI::App& subcommand)
+        : count_{1}
+        , cli_opt_{subcommand.add_option("--sockets", count_, "Select the number of sockets sharing the port, each one with its own receiver thread", true)}
+    {
+        cli_opt_->check(CLI::Range(1, 64));
+    }
+
+    bool is_enable() const { return bool(*cli_opt_); }
+    uint16_t get_count() const { return count_; }
+
+protected:
+    uint16_t count_;
+    CLI::Option* cli_opt_;
+};
+#endif
+
+/*************************************************************************************************
+ * Send Batch CLI Option
+ *************************************************************************************************/
+class SendBatchOpt
+{
+public:
+    SendBatchOpt(CLI::App& subcommand)
+        : size_{1}
+        , cli_opt_{subcommand.add_option("--send-batch", size_, "Select the maximum number of messages flushed per call", true)}
+    {
+        cli_opt_->check(CLI::Range(1, 1024));
+    }
+
+    bool is_enable() const { return bool(*cli_opt_); }
+    uint16_t get_size() const { return size_; }
+
+protected:
+    uint16_t size_;
+    CLI::Option* cli_opt_;
+};
+
+/*************************************************************************************************
+ * Workers CLI Option
+ *************************************************************************************************/
+class WorkersOpt
+{
+public:
+    WorkersOpt(CLI::App& subcommand)
+        : count_{1}
+        , cli_opt_{subcommand.add_option("--workers", count_, "Select the number of processing threads", true)}
+    {
+        cli_opt_->check(CLI::Range(1, 256));
+    }
+
+    bool is_enable() const { return bool(*cli_opt_); }
+    uint16_t get_count() const { return count_; }
+
+protected:
+    uint16_t count_;
+    CLI::Option* cli_opt_;
+};
+
+/*************************************************************************************************
+ * Queue Size CLI Option
+ *************************************************************************************************/
+class QueueSizeOpt
+{
+public:
+    QueueSizeOpt(CLI::App& subcommand)
+        : size_{eprosima::uxr::SERVER_QUEUE_MAX_SIZE}
+        , cli_opt_{subcommand.add_option("--queue-size", size_, "Select the maximum number of packets queued by the server", true)}
+    {
+        cli_opt_->check(CLI::Range(1, 1 << 20));
+    }
+
+    bool is_enable() const { return bool(*cli_opt_); }
+    uint32_t get_size() const { return size_; }
+
+protected:
+    uint32_t size_;
+    CLI::Option* cli_opt_;
+};
+
+/*************************************************************************************************
+ * Stream Depth CLI Option
+ *************************************************************************************************/
+class StreamDepthOpt
+{
+public:
+    StreamDepthOpt(CLI::App& subcommand)
+        : best_effort_depth_{eprosima::uxr::BEST_EFFORT_STREAM_DEPTH}
+        , reliable_depth_{eprosima::uxr::RELIABLE_STREAM_DEPTH}
+        , best_effort_opt_{subcommand.add_option("--best-effort-depth", best_effort_depth_, "Select the default depth of the best-effort streams", true)}
+        , reliable_opt_{subcommand.add_option("--reliable-depth", reliable_depth_, "Select the default depth of the reliable streams", true)}
+    {
+        best_effort_opt_->check(CLI::Range(1, int(eprosima::uxr::MAX_STREAM_DEPTH)));
+        reliable_opt_->check(CLI::Range(1, int(eprosima::uxr::MAX_STREAM_DEPTH)));
+    }
+
+    bool is_enable() const { return bool(*best_effort_opt_) || bool(*reliable_opt_); }
+    uint16_t get_best_effort_depth() const { return best_effort_depth_; }
+    uint16_t get_reliable_depth() const { return reliable_depth_; }
+
+protected:
+    uint16_t best_effort_depth_;
+    uint16_t reliable_depth_;
+    CLI::Option* best_effort_opt_;
+    CLI::Option* reliable_opt_;
+};
+
+/*************************************************************************************************
+ * Scheduler CLI Option
+ *************************************************************************************************/
+class SchedulerOpt
+{
+public:
+    SchedulerOpt(CLI::App& subcommand)
+        : kind_{"fcfs"}
+        , set_{"fcfs", "ring"}
+        , cli_opt_{subcommand.add_set("--scheduler", kind_, set_, "Select the kind of input queues used by the server", true)}
+    {}
+
+    bool is_enable() const { return bool(*cli_opt_); }
+
+    eprosima::uxr::SchedulerKind get_kind() const
+    {
+        return ("ring" == kind_) ? eprosima::uxr::SchedulerKind::RING : eprosima::uxr::SchedulerKind::FCFS;
+    }
+
+protected:
+    std::string kind_;
+    std::set<std::string> set_;
+    CLI::Option* cli_opt_;
+};
+
+/*************************************************************************************************
+ * Coalesce CLI Option
+ *************************************************************************************************/
+class CoalesceOpt
+{
+public:
+    CoalesceOpt(CLI::App& subcommand)
+        : window_{0}
+        , cli_opt_{subcommand.add_option("--coalesce", window_, "Select the time in milliseconds samples wait to be packed in the same message (0 disables it)", true)}
+    {
+        cli_opt_->check(CLI::Range(0, 1000));
+    }
+
+    bool is_enable() const { return bool(*cli_opt_); }
+    std::chrono::milliseconds get_window() const { return std::chrono::milliseconds(window_); }
+
+protected:
+    uint16_t window_;
+    CLI::Option* cli_opt_;
+};
+
+/*************************************************************************************************
+ * Overflow CLI Option
+ *************************************************************************************************/
+class OverflowOpt
+{
+public:
+    OverflowOpt(CLI::App& subcommand)
+        : input_policy_{"drop-oldest"}
+        , output_policy_{"drop-oldest"}
+        , set_{"drop-oldest", "drop-newest", "block"}
+        , timeout_{100}
+        , input_opt_{subcommand.add_set("--input-overflow", input_policy_, set_, "Select what a full input queue does", true)}
+        , output_opt_{subcommand.add_set("--output-overflow", output_policy_, set_, "Select what a full output queue does", true)}
+        , timeout_opt_{subcommand.add_option("--block-timeout", timeout_, "Select the blocking timeout in milliseconds", true)}
+    {}
+
+    bool is_enable() const { return bool(*input_opt_) || bool(*output_opt_); }
+    eprosima::uxr::OverflowPolicy get_input_policy() const { return to_policy(input_policy_); }
+    eprosima::uxr::OverflowPolicy get_output_policy() const { return to_policy(output_policy_); }
+    std::chrono::milliseconds get_timeout() const { return std::chrono::milliseconds(timeout_); }
+
+protected:
+    static eprosima::uxr::OverflowPolicy to_policy(const std::string& policy)
+    {
+        if ("block" == policy)
+        {
+            return eprosima::uxr::OverflowPolicy::BLOCK;
+        }
+        if ("drop-newest" == policy)
+        {
+            return eprosima::uxr::OverflowPolicy::DROP_NEWEST;
+        }
+        return eprosima::uxr::OverflowPolicy::DROP_OLDEST;
+    }
+
+protected:
+    std::string input_policy_;
+    std::string output_policy_;
+    std::set<std::string> set_;
+    uint32_t timeout_;
+    CLI::Option* input_opt_;
+    CLI::Option* output_opt_;
+    CLI::Option* timeout_opt_;
+};
+
 /*************************************************************************************************
  * Common CLI Opts
  *************************************************************************************************/
@@ -200,6 +425,13 @@ public:
         : middleware_opt_{subcommand}
         , reference_opt_{subcommand}
         , verbose_opt_{subcommand}
+        , send_batch_opt_{subcommand}
+        , workers_opt_{subcommand}
+        , queue_size_opt_{subcommand}
+        , stream_depth_opt_{subcommand}
+        , scheduler_opt_{subcommand}
+        , overflow_opt_{subcommand}
+        , coalesce_opt_{subcommand}
 #ifdef UAGENT_DISCOVERY_PROFILE
         , discovery_opt_{subcommand}
 #endif
@@ -211,6 +443,13 @@ public:
     MiddlewareOpt middleware_opt_;
     ReferenceOpt reference_opt_;
     VerboseOpt verbose_opt_;
+    SendBatchOpt send_batch_opt_;
+    WorkersOpt workers_opt_;
+    QueueSizeOpt queue_size_opt_;
+    StreamDepthOpt stream_depth_opt_;
+    SchedulerOpt scheduler_opt_;
+    OverflowOpt overflow_opt_;
+    CoalesceOpt coalesce_opt_;
 #ifdef UAGENT_DISCOVERY_PROFILE
     DiscoveryOpt discovery_opt_;
 #endif
@@ -265,7 +504,7 @@ private:
     void server_callback()
     {
         std::cout << "Enter 'q' for exit" << std::endl;
-        if (launch_server())
+        if (launch_server() && run_server())
         {
 #ifdef UAGENT_DISCOVERY_PROFILE
             if (opts_ref_.discovery_opt_.is_enable())
@@ -293,8 +532,40 @@ private:
         }
     }
 
+    bool run_server()
+    {
+        return check_option(server_->set_send_batch_size(opts_ref_.send_batch_opt_.get_size()), "--send-batch")
+            && check_option(server_->set_queue_size(opts_ref_.queue_size_opt_.get_size()), "--queue-size")
+            && check_option(server_->set_worker_count(opts_ref_.workers_opt_.get_count()), "--workers")
+            && check_option(server_->set_stream_depths(opts_ref_.stream_depth_opt_.get_best_effort_depth(),
+                                                       opts_ref_.stream_depth_opt_.get_reliable_depth()),
+                            "--best-effort-depth/--reliable-depth")
+            && check_option(server_->set_scheduler_kind(opts_ref_.scheduler_opt_.get_kind()), "--scheduler")
+            && check_option(server_->set_input_overflow_policy(opts_ref_.overflow_opt_.get_input_policy(),
+                                                               opts_ref_.overflow_opt_.get_timeout()),
+                            "--input-overflow")
+            && check_option(server_->set_output_overflow_policy(opts_ref_.overflow_opt_.get_output_policy(),
+                                                                opts_ref_.overflow_opt_.get_timeout()),
+                            "--output-overflow")
+            && check_option(server_->set_coalescing_window(opts_ref_.coalesce_opt_.get_window()), "--coalesce")
+            && server_->run();
+    }
+
     virtual bool launch_server() = 0;
 
+protected:
+    /* Options are checked against each other by the server, a rejected one stops the startup. */
+    static bool check_option(
+            bool accepted,
+            const char* option)
+    {
+        if (!accepted)
+        {
+            std::cerr << "Error: rejected option " << option << std::endl;
+        }
+        return accepted;
+    }
+
 protected:
     std::unique_ptr<eprosima::uxr::Server> server_;
     CLI::App* cli_subcommand_;
@@ -311,6 +582,10 @@ public:
     UDPSubcommand(CLI::App& app)
         : ServerSubcommand{app, "udp", "Launch a UDP server", common_opts_}
         , cli_opt_{cli_subcommand_->add_option("-p,--port", port_, "Select the port")}
+        , recv_batch_opt_{*cli_subcommand_}
+#ifndef _WIN32
+        , sockets_opt_{*cli_subcommand_}
+#endif
         , common_opts_{*cli_subcommand_}
     {
         cli_opt_->required(true);
@@ -321,13 +596,22 @@ public:
 private:
     bool launch_server()
     {
-        server_.reset(new eprosima::uxr::UDPv4Agent(port_, common_opts_.middleware_opt_.get_kind()));
-        return server_->run();
+        eprosima::uxr::UDPv4Agent* udp_server = new eprosima::uxr::UDPv4Agent(port_, common_opts_.middleware_opt_.get_kind());
+        bool rv = true;
+#ifndef _WIN32
+        rv = check_option(udp_server->set_socket_count(sockets_opt_.get_count()), "--sockets");
+#endif
+        server_.reset(udp_server);
+        return rv && check_option(server_->set_recv_batch_size(recv_batch_opt_.get_size()), "--recv-batch");
     }
 
 private:
     uint16_t port_;
     CLI::Option* cli_opt_;
+    RecvBatchOpt recv_batch_opt_;
+#ifndef _WIN32
+    SocketsOpt sockets_opt_;
+#endif
     CommonOpts common_opts_;
 };
 
@@ -351,7 +635,7 @@ private:
     bool launch_server()
     {
         server_.reset(new eprosima::uxr::TCPv4Agent(port_, common_opts_.middleware_opt_.get_kind()));
-        return server_->run();
+        return true;
     }
 
 private:
@@ -430,7 +714,7 @@ private:
                 if (0 == tcsetattr(fd, TCSANOW, &attr))
                 {
                     server_.reset(new eprosima::uxr::SerialAgent(fd, 0, common_opts_.middleware_opt_.get_kind()));
-                    rv = server_->run();
+                    rv = true;
                 }
             }
         }
@@ -484,9 +768,9 @@ private:
                 /* Log. */
                 std::cout << "Pseudo-Serial device opend at " << dev << std::endl;
 
-                /* Run server. */
+                /* Create server. */
                 server_.reset(new eprosima::uxr::SerialAgent(fd, 0x00, common_opts_.middleware_opt_.get_kind()));
-                rv = server_->run();
+                rv = true;
             }
         }
 
@@ -0,0 +1,162 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_UTILS_LOCK_FREE_QUEUE_HPP_
+#define UXR_AGENT_UTILS_LOCK_FREE_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace eprosima {
+namespace uxr {
+namespace utils {
+
+/**
+ * Bounded multi-producer multi-consumer queue. Elements are stored in a pre-sized array of slots,
+ * each one tagged with a sequence number that tells producers and consumers whether it is free
+ * or filled. The capacity is rounded up to a power of two.
+ */
+template<class T>
+class LockFreeQueue
+{
+public:
+    explicit LockFreeQueue(
+            size_t max_size)
+        : capacity_{round_capacity(max_size)}
+        , mask_{capacity_ - 1}
+        , slots_{new Slot[capacity_]}
+        , enqueue_pos_{0}
+        , dequeue_pos_{0}
+    {
+        for (size_t i = 0; i < capacity_; ++i)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(LockFreeQueue&&) = delete;
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    bool try_push(
+            T& element);
+
+    bool try_pop(
+            T& element);
+
+    bool empty() const;
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T element;
+    };
+
+    static size_t round_capacity(size_t max_size)
+    {
+        size_t capacity = 2;
+        while (capacity < max_size)
+        {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+private:
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> enqueue_pos_;
+    std::atomic<size_t> dequeue_pos_;
+};
+
+template<class T>
+inline bool LockFreeQueue<T>::try_push(
+        T& element)
+{
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot& slot = slots_[pos & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+        if (0 == diff)
+        {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                slot.element = std::move(element);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (0 > diff)
+        {
+            return false;
+        }
+        else
+        {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<class T>
+inline bool LockFreeQueue<T>::try_pop(
+        T& element)
+{
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot& slot = slots_[pos & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+        if (0 == diff)
+        {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                element = std::move(slot.element);
+                slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (0 > diff)
+        {
+            return false;
+        }
+        else
+        {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<class T>
+inline bool LockFreeQueue<T>::empty() const
+{
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    size_t sequence = slots_[pos & mask_].sequence.load(std::memory_order_acquire);
+    return sequence != pos + 1;
+}
+
+} // namespace utils
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_UTILS_LOCK_FREE_QUEUE_HPP_
@@ -0,0 +1,120 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_UTILS_RTT_ESTIMATOR_HPP_
+#define UXR_AGENT_UTILS_RTT_ESTIMATOR_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace eprosima {
+namespace uxr {
+namespace utils {
+
+/**
+ * Round-trip time estimator and retransmission timeout, as computed by TCP (RFC 6298).
+ * The timeout is clamped to [min_rto, max_rto] and doubled on every backoff until a new sample arrives.
+ */
+class RttEstimator
+{
+public:
+    RttEstimator(
+            std::chrono::milliseconds initial_rto,
+            std::chrono::milliseconds min_rto,
+            std::chrono::milliseconds max_rto);
+
+    void reset();
+
+    void update(std::chrono::microseconds sample);
+
+    void back_off();
+
+    bool has_sample() const { return has_sample_; }
+
+    std::chrono::microseconds get_srtt() const { return srtt_; }
+
+    std::chrono::milliseconds get_rto() const { return rto_; }
+
+private:
+    void set_rto(std::chrono::microseconds rto);
+
+private:
+    const std::chrono::milliseconds initial_rto_;
+    const std::chrono::milliseconds min_rto_;
+    const std::chrono::milliseconds max_rto_;
+    std::chrono::microseconds srtt_;
+    std::chrono::microseconds rttvar_;
+    std::chrono::milliseconds rto_;
+    bool has_sample_;
+};
+
+inline RttEstimator::RttEstimator(
+        std::chrono::milliseconds initial_rto,
+        std::chrono::milliseconds min_rto,
+        std::chrono::milliseconds max_rto)
+    : initial_rto_(initial_rto)
+    , min_rto_(min_rto)
+    , max_rto_(max_rto)
+    , srtt_(0)
+    , rttvar_(0)
+    , rto_(initial_rto)
+    , has_sample_(false)
+{}
+
+inline void RttEstimator::reset()
+{
+    srtt_ = std::chrono::microseconds(0);
+    rttvar_ = std::chrono::microseconds(0);
+    rto_ = initial_rto_;
+    has_sample_ = false;
+}
+
+inline void RttEstimator::update(std::chrono::microseconds sample)
+{
+    if (has_sample_)
+    {
+        /* RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R|, SRTT = 7/8 * SRTT + 1/8 * R. */
+        const std::chrono::microseconds error = (srtt_ > sample) ? (srtt_ - sample) : (sample - srtt_);
+        rttvar_ = (3 * rttvar_ + error) / 4;
+        srtt_ = (7 * srtt_ + sample) / 8;
+    }
+    else
+    {
+        srtt_ = sample;
+        rttvar_ = sample / 2;
+        has_sample_ = true;
+    }
+    /* The clock granularity is the millisecond of the timer wheel. */
+    set_rto(srtt_ + std::max<std::chrono::microseconds>(std::chrono::milliseconds(1), 4 * rttvar_));
+}
+
+inline void RttEstimator::back_off()
+{
+    set_rto(2 * std::chrono::duration_cast<std::chrono::microseconds>(rto_));
+}
+
+inline void RttEstimator::set_rto(std::chrono::microseconds rto)
+{
+    /* Rounded up to the timer tick. */
+    std::chrono::milliseconds rto_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(rto + std::chrono::microseconds(999));
+    rto_ = std::min(max_rto_, std::max(min_rto_, rto_ms));
+}
+
+} // namespace utils
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_UTILS_RTT_ESTIMATOR_HPP_
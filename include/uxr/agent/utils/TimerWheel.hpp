@@ -0,0 +1,372 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UXR_AGENT_UTILS_TIMER_WHEEL_HPP_
+#define UXR_AGENT_UTILS_TIMER_WHEEL_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace utils {
+
+/**
+ * Hierarchical timer wheel with millisecond ticks.
+ * Each level has 64 slots, and a slot of level N covers 64^N ticks. Timers are kept in the lowest level
+ * able to hold their deadline and are cascaded down as the wheel turns, so scheduling, cancelling and
+ * expiring a timer are constant-time operations and an empty slot costs nothing on advance.
+ * It is not thread safe, the owner is expected to serialize the calls.
+ */
+class TimerWheel
+{
+public:
+    typedef uint64_t Tick;
+    typedef uint64_t TimerId;
+    typedef std::function<void ()> Callback;
+
+    static constexpr TimerId INVALID_TIMER = 0;
+    static constexpr Tick NEVER = std::numeric_limits<Tick>::max();
+
+    explicit TimerWheel(
+            Tick now = 0)
+        : current_tick_{now}
+        , size_{0}
+        , free_node_{NIL}
+    {
+        for (auto& level : levels_)
+        {
+            level.occupied = 0;
+            level.heads.fill(uint32_t(NIL));
+        }
+    }
+
+    TimerWheel(TimerWheel&&) = delete;
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    static Tick to_tick(
+            std::chrono::steady_clock::time_point time_point)
+    {
+        return Tick(std::chrono::duration_cast<std::chrono::milliseconds>(time_point.time_since_epoch()).count());
+    }
+
+    static std::chrono::steady_clock::time_point to_time_point(
+            Tick tick)
+    {
+        return std::chrono::steady_clock::time_point(std::chrono::milliseconds(tick));
+    }
+
+    /**
+     * Schedules a callback to expire at a given tick. Deadlines already reached expire on the next tick.
+     */
+    TimerId schedule(
+            Tick deadline,
+            Callback callback);
+
+    /**
+     * Cancels a timer which has not expired yet.
+     */
+    bool cancel(
+            TimerId timer_id);
+
+    /**
+     * Turns the wheel up to a given tick, moving the callbacks of the expired timers into expired.
+     */
+    void advance(
+            Tick now,
+            std::vector<Callback>& expired);
+
+    /**
+     * Lower bound of the next expiration, that is, the next tick at which advance may have work to do.
+     * It returns NEVER if there is no timer.
+     */
+    Tick next_event() const;
+
+    Tick get_current_tick() const { return current_tick_; }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return 0 == size_; }
+
+private:
+    static constexpr size_t LEVEL_BITS = 6;
+    static constexpr size_t SLOT_COUNT = size_t(1) << LEVEL_BITS;
+    static constexpr size_t SLOT_MASK = SLOT_COUNT - 1;
+    static constexpr size_t LEVEL_COUNT = 4;
+    static constexpr Tick MAX_DELTA = (Tick(1) << (LEVEL_BITS * LEVEL_COUNT)) - 1;
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+    struct Node
+    {
+        Tick deadline;
+        Callback callback;
+        uint32_t generation;
+        uint32_t prev;
+        uint32_t next;
+        uint8_t level;
+        uint8_t slot;
+        bool linked;
+    };
+
+    struct Level
+    {
+        uint64_t occupied;
+        std::array<uint32_t, SLOT_COUNT> heads;
+    };
+
+    void link(
+            uint32_t index);
+
+    void unlink(
+            uint32_t index);
+
+    void release(
+            uint32_t index);
+
+    void tick(
+            std::vector<Callback>& expired);
+
+private:
+    Tick current_tick_;
+    size_t size_;
+    std::array<Level, LEVEL_COUNT> levels_;
+    std::vector<Node> nodes_;
+    uint32_t free_node_;
+};
+
+inline TimerWheel::TimerId TimerWheel::schedule(
+        Tick deadline,
+        Callback callback)
+{
+    uint32_t index;
+    if (NIL != free_node_)
+    {
+        index = free_node_;
+        free_node_ = nodes_[index].next;
+    }
+    else
+    {
+        index = uint32_t(nodes_.size());
+        nodes_.emplace_back();
+        nodes_[index].generation = 0;
+    }
+
+    Node& node = nodes_[index];
+    node.deadline = (deadline > current_tick_) ? deadline : current_tick_ + 1;
+    node.callback = std::move(callback);
+    node.generation += 1;
+    node.linked = false;
+    link(index);
+    ++size_;
+
+    return (TimerId(node.generation) << 32) | (TimerId(index) + 1);
+}
+
+inline bool TimerWheel::cancel(
+        TimerId timer_id)
+{
+    bool rv = false;
+    const uint32_t index = uint32_t(timer_id & 0xFFFFFFFF) - 1;
+    const uint32_t generation = uint32_t(timer_id >> 32);
+    if ((INVALID_TIMER != timer_id) && (index < nodes_.size()) &&
+        (nodes_[index].generation == generation) && nodes_[index].linked)
+    {
+        unlink(index);
+        release(index);
+        --size_;
+        rv = true;
+    }
+    return rv;
+}
+
+inline void TimerWheel::advance(
+        Tick now,
+        std::vector<Callback>& expired)
+{
+    while (current_tick_ < now)
+    {
+        /* Ticks without work are skipped at once. */
+        const Tick next = next_event();
+        if (next > now)
+        {
+            current_tick_ = now;
+        }
+        else
+        {
+            current_tick_ = next - 1;
+            tick(expired);
+        }
+    }
+}
+
+inline TimerWheel::Tick TimerWheel::next_event() const
+{
+    Tick rv = NEVER;
+    if (0 != size_)
+    {
+        for (size_t l = 0; l < LEVEL_COUNT; ++l)
+        {
+            const uint64_t occupied = levels_[l].occupied;
+            if (0 != occupied)
+            {
+                /* First occupied slot after the current one, wrapping around. */
+                const Tick position = current_tick_ >> (LEVEL_BITS * l);
+                const size_t shift = size_t((position + 1) & SLOT_MASK);
+                const uint64_t rotated = (0 == shift) ? occupied : ((occupied >> shift) | (occupied << (SLOT_COUNT - shift)));
+                size_t distance = 0;
+                while (0 == ((rotated >> distance) & 1))
+                {
+                    ++distance;
+                }
+                const Tick event = (position + 1 + distance) << (LEVEL_BITS * l);
+                rv = (event < rv) ? event : rv;
+            }
+        }
+    }
+    return rv;
+}
+
+inline void TimerWheel::link(
+        uint32_t index)
+{
+    Node& node = nodes_[index];
+    const Tick delta = node.deadline - current_tick_;
+    const Tick placement = (delta > MAX_DELTA) ? current_tick_ + MAX_DELTA : node.deadline;
+
+    size_t level = 0;
+    while ((level + 1 < LEVEL_COUNT) && ((placement - current_tick_) >> (LEVEL_BITS * (level + 1))))
+    {
+        ++level;
+    }
+    const size_t slot = size_t((placement >> (LEVEL_BITS * level)) & SLOT_MASK);
+
+    /* Appended to the tail, so timers sharing a deadline expire in scheduling order. */
+    Level& wheel_level = levels_[level];
+    node.level = uint8_t(level);
+    node.slot = uint8_t(slot);
+    node.next = NIL;
+    node.linked = true;
+    uint32_t head = wheel_level.heads[slot];
+    if (NIL == head)
+    {
+        node.prev = index;
+        wheel_level.heads[slot] = index;
+        wheel_level.occupied |= (uint64_t(1) << slot);
+    }
+    else
+    {
+        /* The head keeps the tail in its prev link. */
+        const uint32_t tail = nodes_[head].prev;
+        node.prev = tail;
+        nodes_[tail].next = index;
+        nodes_[head].prev = index;
+    }
+}
+
+inline void TimerWheel::unlink(
+        uint32_t index)
+{
+    Node& node = nodes_[index];
+    Level& wheel_level = levels_[node.level];
+    uint32_t& head = wheel_level.heads[node.slot];
+    if (head == index)
+    {
+        head = node.next;
+        if (NIL == head)
+        {
+            wheel_level.occupied &= ~(uint64_t(1) << node.slot);
+        }
+        else
+        {
+            nodes_[head].prev = node.prev;
+        }
+    }
+    else
+    {
+        nodes_[node.prev].next = node.next;
+        if (NIL == node.next)
+        {
+            nodes_[head].prev = node.prev;
+        }
+        else
+        {
+            nodes_[node.next].prev = node.prev;
+        }
+    }
+    node.linked = false;
+}
+
+inline void TimerWheel::release(
+        uint32_t index)
+{
+    Node& node = nodes_[index];
+    node.callback = nullptr;
+    node.next = free_node_;
+    free_node_ = index;
+}
+
+inline void TimerWheel::tick(
+        std::vector<Callback>& expired)
+{
+    ++current_tick_;
+
+    /* Cascade from the highest level whose slot boundary has been reached. */
+    size_t top_level = 0;
+    while ((top_level + 1 < LEVEL_COUNT) &&
+           (0 == (current_tick_ & ((Tick(1) << (LEVEL_BITS * (top_level + 1))) - 1))))
+    {
+        ++top_level;
+    }
+    for (size_t l = top_level; 0 < l; --l)
+    {
+        const size_t slot = size_t((current_tick_ >> (LEVEL_BITS * l)) & SLOT_MASK);
+        uint32_t index = levels_[l].heads[slot];
+        levels_[l].heads[slot] = NIL;
+        levels_[l].occupied &= ~(uint64_t(1) << slot);
+        while (NIL != index)
+        {
+            const uint32_t next = nodes_[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    /* Expire. */
+    const size_t slot = size_t(current_tick_ & SLOT_MASK);
+    uint32_t index = levels_[0].heads[slot];
+    levels_[0].heads[slot] = NIL;
+    levels_[0].occupied &= ~(uint64_t(1) << slot);
+    while (NIL != index)
+    {
+        const uint32_t next = nodes_[index].next;
+        nodes_[index].linked = false;
+        expired.push_back(std::move(nodes_[index].callback));
+        release(index);
+        --size_;
+        index = next;
+    }
+}
+
+} // namespace utils
+} // namespace uxr
+} // namespace eprosima
+
+#endif // UXR_AGENT_UTILS_TIMER_WHEEL_HPP_
@@ -426,14 +426,13 @@ bool Agent::write(
 {
     bool rv = false;
 
-    if (std::shared_ptr<ProxyClient> client = root_->get_client(conversion::raw_to_clientkey(client_key)))
+    if (std::shared_ptr<ProxyClient> client = root_->get_client(client_key))
     {
         dds::xrce::ObjectId object_id = conversion::raw_to_objectid(datawriter_id, dds::xrce::OBJK_DATAWRITER);
-        std::shared_ptr<DataWriter> datawriter = std::dynamic_pointer_cast<DataWriter>(client->get_object(object_id));
+        std::shared_ptr<DataWriter> datawriter = client->get_datawriter(object_id);
         if (datawriter)
         {
-            std::vector<uint8_t> data(buf, buf + len);
-            rv = datawriter->write(data);
+            rv = datawriter->write(ByteView(buf, len));
             op_result = rv ? OpResult::OK : OpResult::WRITE_ERROR;
         }
         else
@@ -471,7 +470,7 @@ bool Agent::create_object(
 {
     bool rv = false;
 
-    if (std::shared_ptr<ProxyClient> client = root_->get_client(conversion::raw_to_clientkey(client_key)))
+    if (std::shared_ptr<ProxyClient> client = root_->get_client(client_key))
     {
         dds::xrce::CreationMode creation_mode{};
         creation_mode.reuse(0 != (flag & Agent::REUSE_MODE));
@@ -504,7 +503,7 @@ bool Agent::delete_object(
 {
     bool rv = false;
 
-    if (std::shared_ptr<ProxyClient> client = root_->get_client(conversion::raw_to_clientkey(client_key)))
+    if (std::shared_ptr<ProxyClient> client = root_->get_client(client_key))
     {
         dds::xrce::ResultStatus result = client->delete_object(conversion::raw_to_objectid(raw_id, object_kind));
         op_result = Agent::OpResult(result.status());
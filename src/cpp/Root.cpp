@@ -22,20 +22,68 @@
 #include <fastrtps/xmlparser/XMLProfileManager.h>
 #endif
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <memory>
 #include <chrono>
+#include <string>
 
 constexpr dds::xrce::XrceVendorId EPROSIMA_VENDOR_ID = {0x01, 0x0F};
 
 namespace eprosima {
 namespace uxr {
 
+/* Depth requested through a CREATE_CLIENT property, limited to MAX_STREAM_DEPTH. */
+static uint16_t get_requested_depth(
+        const dds::xrce::Property& property,
+        uint16_t default_depth)
+{
+    uint16_t rv = default_depth;
+    char* end = nullptr;
+    const unsigned long depth = std::strtoul(property.value().c_str(), &end, 10);
+
+    /* strtoul skips leading whitespace and wraps negative values around, only plain digits are accepted. */
+    if (!property.value().empty() && std::isdigit(static_cast<unsigned char>(property.value().front()))
+        && ('\0' == *end) && (0 < depth))
+    {
+        rv = uint16_t(std::min(depth, (unsigned long)(MAX_STREAM_DEPTH)));
+    }
+    return rv;
+}
+
+static StreamDepths negotiate_stream_depths(
+        const dds::xrce::CLIENT_Representation& client_representation,
+        const StreamDepths& default_depths,
+        bool& requested)
+{
+    StreamDepths rv = default_depths;
+    requested = false;
+    const eprosima::Optional<dds::xrce::PropertySeq> properties = client_representation.properties();
+    if (properties)
+    {
+        for (const auto& property : *properties)
+        {
+            if (BEST_EFFORT_DEPTH_PROPERTY == property.name())
+            {
+                rv.best_effort = get_requested_depth(property, default_depths.best_effort);
+                requested = true;
+            }
+            else if (RELIABLE_DEPTH_PROPERTY == property.name())
+            {
+                rv.reliable = get_requested_depth(property, default_depths.reliable);
+                requested = true;
+            }
+        }
+    }
+    return rv;
+}
+
 Root::Root()
     : mtx_(),
-      clients_(),
-      current_client_()
+      clients_(std::make_shared<ClientMap>()),
+      stream_depths_{BEST_EFFORT_STREAM_DEPTH, RELIABLE_STREAM_DEPTH}
 {
-    current_client_ = clients_.begin();
 #ifdef UAGENT_LOGGER_PROFILE
     spdlog::set_level(spdlog::level::info);
     spdlog::set_pattern(UXR_LOG_PATTERN);
@@ -65,21 +113,26 @@ dds::xrce::ResultStatus Root::create_client(
 
     dds::xrce::ResultStatus result_status;
     result_status.status(dds::xrce::STATUS_OK);
+    bool depths_requested = false;
+    StreamDepths stream_depths;
 
     if (client_representation.xrce_cookie() == dds::xrce::XRCE_COOKIE)
     {
         if (client_representation.xrce_version()[0] == dds::xrce::XRCE_VERSION_MAJOR)
         {
             std::lock_guard<std::mutex> lock(mtx_);
+            stream_depths = negotiate_stream_depths(client_representation, stream_depths_, depths_requested);
             dds::xrce::ClientKey client_key = client_representation.client_key();
             dds::xrce::SessionId session_id = client_representation.session_id();
-            auto it = clients_.find(client_key);
-            if (it == clients_.end())
+            std::shared_ptr<ClientMap> clients = copy_clients();
+            auto it = clients->find(conversion::clientkey_to_raw(client_key));
+            if (it == clients->end())
             {
                 std::shared_ptr<ProxyClient> new_client
-                        = std::make_shared<ProxyClient>(client_representation, middleware_kind);
-                if (clients_.emplace(client_key, std::move(new_client)).second)
+                        = std::make_shared<ProxyClient>(client_representation, middleware_kind, stream_depths);
+                if (clients->emplace(conversion::clientkey_to_raw(client_key), std::move(new_client)).second)
                 {
+                    publish_clients(std::move(clients));
                     UXR_AGENT_LOG_INFO(
                         UXR_DECORATE_GREEN("create"),
                         UXR_CREATE_SESSION_PATTERN,
@@ -98,10 +151,11 @@ dds::xrce::ResultStatus Root::create_client(
             }
             else
             {
-                std::shared_ptr<ProxyClient> client = clients_.at(client_key);
-                if (session_id != client->get_session_id())
+                std::shared_ptr<ProxyClient> client = it->second;
+                if ((session_id != client->get_session_id()) || (stream_depths != client->get_stream_depths()))
                 {
-                    it->second = std::make_shared<ProxyClient>(client_representation, middleware_kind);
+                    it->second = std::make_shared<ProxyClient>(client_representation, middleware_kind, stream_depths);
+                    publish_clients(std::move(clients));
                 }
                 else
                 {
@@ -133,6 +187,17 @@ dds::xrce::ResultStatus Root::create_client(
     agent_representation.xrce_version(dds::xrce::XRCE_VERSION);
     agent_representation.xrce_vendor_id(EPROSIMA_VENDOR_ID);
 
+    /* The depths granted are only reported to the clients which asked for them. */
+    if (depths_requested && (dds::xrce::STATUS_OK == result_status.status()))
+    {
+        dds::xrce::PropertySeq properties(2);
+        properties[0].name(BEST_EFFORT_DEPTH_PROPERTY);
+        properties[0].value(std::to_string(stream_depths.best_effort));
+        properties[1].name(RELIABLE_DEPTH_PROPERTY);
+        properties[1].value(std::to_string(stream_depths.reliable));
+        agent_representation.properties(std::move(properties));
+    }
+
     return result_status;
 }
 
@@ -157,14 +222,12 @@ dds::xrce::ResultStatus Root::get_info(dds::xrce::ObjectInfo& agent_info)
 dds::xrce::ResultStatus Root::delete_client(const dds::xrce::ClientKey& client_key)
 {
     dds::xrce::ResultStatus result_status;
-    if (get_client(client_key))
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::shared_ptr<ClientMap> clients = copy_clients();
+    if (0 != clients->erase(conversion::clientkey_to_raw(client_key)))
     {
-        std::lock_guard<std::mutex> lock(mtx_);
-        if (current_client_ != clients_.end() && client_key == current_client_->first)
-        {
-            ++current_client_;
-        }
-        clients_.erase(client_key);
+        /* The client is destroyed once the last snapshot holding it is released. */
+        publish_clients(std::move(clients));
         result_status.status(dds::xrce::STATUS_OK);
         UXR_AGENT_LOG_INFO(
             UXR_DECORATE_GREEN("delete"),
@@ -184,32 +247,35 @@ dds::xrce::ResultStatus Root::delete_client(const dds::xrce::ClientKey& client_k
 }
 
 std::shared_ptr<ProxyClient> Root::get_client(const dds::xrce::ClientKey& client_key)
+{
+    return get_client(conversion::clientkey_to_raw(client_key));
+}
+
+std::shared_ptr<ProxyClient> Root::get_client(uint32_t raw_client_key)
 {
     std::shared_ptr<ProxyClient> client;
-    std::lock_guard<std::mutex> lock(mtx_);
-    auto it = clients_.find(client_key);
-    if (it != clients_.end())
+    std::shared_ptr<const ClientMap> clients = get_clients();
+    auto it = clients->find(raw_client_key);
+    if (it != clients->end())
     {
-        client = clients_.at(client_key);
+        client = it->second;
     }
     return client;
 }
 
-bool Root::get_next_client(std::shared_ptr<ProxyClient>& next_client)
+std::shared_ptr<const Root::ClientMap> Root::get_clients() const
 {
-    bool rv = false;
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (current_client_ != clients_.end())
-    {
-        next_client = current_client_->second;
-        ++current_client_;
-        rv = true;
-    }
-    else
-    {
-        current_client_ = clients_.begin();
-    }
-    return rv;
+    return std::atomic_load(&clients_);
+}
+
+std::shared_ptr<Root::ClientMap> Root::copy_clients() const
+{
+    return std::make_shared<ClientMap>(*clients_);
+}
+
+void Root::publish_clients(std::shared_ptr<ClientMap>&& clients)
+{
+    std::atomic_store(&clients_, std::shared_ptr<const ClientMap>(std::move(clients)));
 }
 
 bool Root::load_config_file(const std::string& file_path)
@@ -280,11 +346,23 @@ void Root::set_verbose_level(uint8_t verbose_level)
 #endif
 }
 
+bool Root::set_stream_depths(const StreamDepths& stream_depths)
+{
+    bool rv = false;
+    if ((0 < stream_depths.best_effort) && (MAX_STREAM_DEPTH >= stream_depths.best_effort) &&
+        (0 < stream_depths.reliable) && (MAX_STREAM_DEPTH >= stream_depths.reliable))
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stream_depths_ = stream_depths;
+        rv = true;
+    }
+    return rv;
+}
+
 void Root::reset()
 {
     std::lock_guard<std::mutex> lock(mtx_);
-    clients_.clear();
-    current_client_ = clients_.begin();
+    publish_clients(std::make_shared<ClientMap>());
 }
 
 } // namespace uxr
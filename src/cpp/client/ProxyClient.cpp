@@ -33,10 +33,15 @@ namespace uxr {
 
 ProxyClient::ProxyClient(
         const dds::xrce::CLIENT_Representation& representation,
-        Middleware::Kind middleware_kind)
+        Middleware::Kind middleware_kind,
+        const StreamDepths& stream_depths)
     : representation_(representation)
     , objects_()
-    , session_(SessionInfo{representation.client_key(), representation.session_id(), representation.mtu()})
+    , datawriters_()
+    , datareaders_()
+    , session_(SessionInfo{representation.client_key(), representation.session_id(), representation.mtu()},
+               stream_depths)
+    , source_()
 {
     switch (middleware_kind)
     {
@@ -193,6 +198,26 @@ std::shared_ptr<XRCEObject> ProxyClient::get_object(const dds::xrce::ObjectId& o
     return object;
 }
 
+std::shared_ptr<DataWriter> ProxyClient::get_datawriter(const dds::xrce::ObjectId& object_id) const
+{
+    std::shared_ptr<DataWriter> datawriter;
+    if (dds::xrce::OBJK_DATAWRITER == (object_id[1] & 0x0F))
+    {
+        datawriter = datawriters_.get(conversion::objectid_to_raw(object_id));
+    }
+    return datawriter;
+}
+
+std::shared_ptr<DataReader> ProxyClient::get_datareader(const dds::xrce::ObjectId& object_id) const
+{
+    std::shared_ptr<DataReader> datareader;
+    if (dds::xrce::OBJK_DATAREADER == (object_id[1] & 0x0F))
+    {
+        datareader = datareaders_.get(conversion::objectid_to_raw(object_id));
+    }
+    return datareader;
+}
+
 Session& ProxyClient::session()
 {
     return session_;
@@ -471,10 +496,11 @@ bool ProxyClient::create_datawriter(
     if (it != objects_.end())
     {
         std::shared_ptr<Publisher> publisher = std::dynamic_pointer_cast<Publisher>(it->second);
-        if (std::unique_ptr<DataWriter> datawriter = DataWriter::create(object_id, publisher, representation, objects_))
+        if (std::shared_ptr<DataWriter> datawriter = DataWriter::create(object_id, publisher, representation, objects_))
         {
-            if (objects_.emplace(object_id, std::move(datawriter)).second)
+            if (objects_.emplace(object_id, datawriter).second)
             {
+                datawriters_.set(conversion::objectid_to_raw(object_id), datawriter);
                 UXR_AGENT_LOG_DEBUG(
                     UXR_DECORATE_GREEN("datawriter created"),
                     UXR_CREATE_DATAWRITER_PATTERN,
@@ -530,10 +556,11 @@ bool ProxyClient::create_datareader(
     if (it != objects_.end())
     {
         std::shared_ptr<Subscriber> subscriber = std::dynamic_pointer_cast<Subscriber>(it->second);
-        if (std::unique_ptr<DataReader> datareader = DataReader::create(object_id, subscriber, representation, objects_))
+        if (std::shared_ptr<DataReader> datareader = DataReader::create(object_id, subscriber, representation, objects_))
         {
-            if (objects_.emplace(object_id, std::move(datareader)).second)
+            if (objects_.emplace(object_id, datareader).second)
             {
+                datareaders_.set(conversion::objectid_to_raw(object_id), datareader);
                 UXR_AGENT_LOG_DEBUG(
                     UXR_DECORATE_GREEN("datareader created"),
                     UXR_CREATE_DATAREADER_PATTERN,
@@ -584,6 +611,7 @@ bool ProxyClient::delete_object_unlock(
     {
         it->second->release(objects_);
         objects_.erase(object_id);
+        prune_object_tables();
         UXR_AGENT_LOG_DEBUG(
             UXR_DECORATE_GREEN("object deleted"),
             UXR_CREATE_OBJECT_PATTERN,
@@ -602,5 +630,17 @@ bool ProxyClient::delete_object_unlock(
     return rv;
 }
 
+void ProxyClient::prune_object_tables()
+{
+    datawriters_.remove_if([this](uint16_t raw_id)
+    {
+        return 0 == objects_.count(conversion::raw_to_objectid(raw_id, dds::xrce::OBJK_DATAWRITER));
+    });
+    datareaders_.remove_if([this](uint16_t raw_id)
+    {
+        return 0 == objects_.count(conversion::raw_to_objectid(raw_id, dds::xrce::OBJK_DATAREADER));
+    });
+}
+
 } // namespace uxr
 } // namespace eprosima
@@ -13,21 +13,24 @@
 // limitations under the License.
 
 #include <uxr/agent/datareader/DataReader.hpp>
+#include <uxr/agent/datareader/DeliveryExecutor.hpp>
+#include <uxr/agent/datareader/SampleBatch.hpp>
 #include <uxr/agent/subscriber/Subscriber.hpp>
 #include <uxr/agent/participant/Participant.hpp>
 #include <uxr/agent/topic/Topic.hpp>
 #include <uxr/agent/middleware/Middleware.hpp>
+#include <uxr/agent/message/OutputMessage.hpp>
 #include <uxr/agent/utils/TokenBucket.hpp>
 #include <uxr/agent/logger/Logger.hpp>
+#include <uxr/agent/config.hpp>
 
-#include <iostream>
-#include <atomic>
+#include <condition_variable>
+#include <thread>
 
 namespace eprosima {
 namespace uxr {
 
-constexpr int READ_TIMEOUT = 100;
-constexpr uint8_t MAX_SLEEP_TIME = 100;
+constexpr size_t MAX_SAMPLES_PER_TASK = 32;
 constexpr uint16_t MAX_SAMPLES_ZERO = 0;
 constexpr uint16_t MAX_SAMPLES_UNLIMITED = 0xFFFF;
 constexpr uint16_t MAX_ELAPSED_TIME_UNLIMITED = 0;
@@ -35,18 +38,10 @@ constexpr uint16_t MAX_BYTES_PER_SECOND_UNLIMITED = 0;
 
 namespace  {
 
-std::chrono::milliseconds get_read_timeout(
-        const std::chrono::steady_clock::time_point& final_time,
-        uint16_t max_elapsed_time)
+DeliveryExecutor& get_delivery_executor()
 {
-    std::chrono::milliseconds rv = std::chrono::milliseconds(READ_TIMEOUT);
-    if (MAX_ELAPSED_TIME_UNLIMITED != max_elapsed_time)
-    {
-        rv = std::min(
-             std::chrono::milliseconds(READ_TIMEOUT),
-             std::chrono::duration_cast<std::chrono::milliseconds>(final_time - std::chrono::steady_clock::now()));
-    }
-    return rv;
+    static DeliveryExecutor delivery_executor(DELIVERY_THREADS);
+    return delivery_executor;
 }
 
 } // unnamed namespace
@@ -106,7 +101,7 @@ DataReader::DataReader(
     : XRCEObject(object_id)
     , subscriber_(subscriber)
     , topic_(topic)
-    , running_cond_(false)
+    , delivery_()
 {
     subscriber_->tie_object(object_id);
     topic_->tie_object(object_id);
@@ -172,94 +167,416 @@ bool DataReader::read(
         delivery_control.max_samples(1);
     }
 
-    switch (read_data.read_specification().data_format())
+    const dds::xrce::DataFormat data_format = read_data.read_specification().data_format();
+    if (!SampleBatch::is_valid_format(data_format))
     {
-        case dds::xrce::FORMAT_DATA:
-            break;
-        case dds::xrce::FORMAT_SAMPLE:
-            break;
-        case dds::xrce::FORMAT_DATA_SEQ:
-            break;
-        case dds::xrce::FORMAT_SAMPLE_SEQ:
-            break;
-        case dds::xrce::FORMAT_PACKED_SAMPLES:
-            break;
-        default:
-            std::cout << "Error: read format unexpected" << std::endl;
-            break;
+        UXR_AGENT_LOG_ERROR(
+            UXR_DECORATE_RED("read format unexpected"),
+            "datareader_id: 0x{:04X}, data_format: 0x{:02X}",
+            get_raw_id(),
+            int(data_format));
+        return false;
     }
 
-    return (stop_read() && start_read(delivery_control, read_cb, cb_args));
+    ReadCallbackArgs format_cb_args(cb_args);
+    format_cb_args.data_format = data_format;
+    return (stop_read() && start_read(delivery_control, read_cb, format_cb_args));
 }
 
-bool DataReader::start_read(
+/**********************************************************************************************************************
+ * Delivery
+ **********************************************************************************************************************/
+class DataReader::Delivery : public std::enable_shared_from_this<DataReader::Delivery>
+{
+public:
+    Delivery(
+            Middleware& middleware,
+            uint16_t raw_id,
+            const dds::xrce::DataDeliveryControl& delivery_control,
+            read_callback read_cb,
+            const ReadCallbackArgs& cb_args);
+
+    void start();
+
+    void stop();
+
+    void notify();
+
+private:
+    enum class Result
+    {
+        DRAINED,
+        PENDING,
+        THROTTLED,
+        FINISHED
+    };
+
+    void run();
+
+    Result deliver(std::chrono::milliseconds& wait_time);
+
+    Result take_sample(
+            SampleBatch& batch,
+            const ByteView& sample,
+            std::chrono::milliseconds& wait_time);
+
+    void append_sample(
+            SampleBatch& batch,
+            const ByteView& sample);
+
+    void keep_sample(const ByteView& sample);
+
+    bool is_complete() const;
+
+    void post();
+
+    void post_at(DeliveryExecutor::TimePoint time_point);
+
+private:
+    Middleware& middleware_;
+    const uint16_t raw_id_;
+    const dds::xrce::DataDeliveryControl delivery_control_;
+    read_callback read_cb_;
+    const ReadCallbackArgs cb_args_;
+    const std::chrono::steady_clock::time_point start_time_;
+    const std::chrono::steady_clock::time_point final_time_;
+    utils::TokenBucket token_bucket_;
+    uint16_t message_count_;
+    uint32_t sequence_number_;
+    DeliveryExecutor::TimerId expiry_timer_;
+    std::vector<uint8_t> data_;
+    bool has_data_;
+    bool active_;
+    bool pending_;
+    bool notified_;
+    bool running_;
+    std::thread::id runner_id_;
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+};
+
+DataReader::Delivery::Delivery(
+        Middleware& middleware,
+        uint16_t raw_id,
         const dds::xrce::DataDeliveryControl& delivery_control,
         read_callback read_cb,
         const ReadCallbackArgs& cb_args)
+    : middleware_(middleware)
+    , raw_id_(raw_id)
+    , delivery_control_(delivery_control)
+    , read_cb_(read_cb)
+    , cb_args_(cb_args)
+    , start_time_(std::chrono::steady_clock::now())
+    , final_time_(start_time_ + std::chrono::seconds(delivery_control.max_elapsed_time()))
+    , token_bucket_((MAX_BYTES_PER_SECOND_UNLIMITED == delivery_control.max_bytes_per_second())
+                    ? SIZE_MAX
+                    : delivery_control.max_bytes_per_second())
+    , message_count_(0)
+    , sequence_number_(0)
+    , expiry_timer_(utils::TimerWheel::INVALID_TIMER)
+    , data_()
+    , has_data_(false)
+    , active_(false)
+    , pending_(false)
+    , notified_(false)
+    , running_(false)
+    , runner_id_()
+{}
+
+void DataReader::Delivery::start()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
-    running_cond_ = true;
-    read_thread_ = std::thread(&DataReader::read_task, this, delivery_control, read_cb, cb_args);
-    return true;
+    std::unique_lock<std::mutex> lock(mtx_);
+    active_ = true;
+    if (MAX_ELAPSED_TIME_UNLIMITED != delivery_control_.max_elapsed_time())
+    {
+        std::weak_ptr<Delivery> weak_delivery(shared_from_this());
+        expiry_timer_ = get_delivery_executor().post_at(final_time_, [weak_delivery]()
+        {
+            if (std::shared_ptr<Delivery> delivery = weak_delivery.lock())
+            {
+                std::lock_guard<std::mutex> expired_lock(delivery->mtx_);
+                delivery->active_ = false;
+                delivery->expiry_timer_ = utils::TimerWheel::INVALID_TIMER;
+            }
+        });
+    }
+    lock.unlock();
+
+    /* Data already available is delivered right away. */
+    notify();
 }
 
-bool DataReader::stop_read()
+void DataReader::Delivery::stop()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    active_ = false;
+    if (utils::TimerWheel::INVALID_TIMER != expiry_timer_)
+    {
+        get_delivery_executor().cancel(expiry_timer_);
+        expiry_timer_ = utils::TimerWheel::INVALID_TIMER;
+    }
+
+    /* A reader destroyed from its own read callback cannot wait for the delivery it is running. */
+    if (std::this_thread::get_id() != runner_id_)
+    {
+        cond_var_.wait(lock, [this]() { return !running_; });
+    }
+}
+
+void DataReader::Delivery::notify()
 {
     std::lock_guard<std::mutex> lock(mtx_);
-    running_cond_ = false;
+    if (active_)
+    {
+        /* A single task per request is queued or running, later notifications just flag it. */
+        if (pending_)
+        {
+            notified_ = true;
+        }
+        else
+        {
+            pending_ = true;
+            post();
+        }
+    }
+}
 
-    if (read_thread_.joinable())
+void DataReader::Delivery::run()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (!active_)
     {
-        read_thread_.join();
+        pending_ = false;
+        return;
     }
-    return true;
+    notified_ = false;
+    running_ = true;
+    runner_id_ = std::this_thread::get_id();
+    lock.unlock();
+
+    std::chrono::milliseconds wait_time(0);
+    Result result = deliver(wait_time);
+
+    lock.lock();
+    running_ = false;
+    runner_id_ = std::thread::id();
+    switch (result)
+    {
+        case Result::DRAINED:
+            if (notified_ && active_)
+            {
+                notified_ = false;
+                post();
+            }
+            else
+            {
+                pending_ = false;
+            }
+            break;
+        case Result::PENDING:
+            post();
+            break;
+        case Result::THROTTLED:
+            post_at(std::chrono::steady_clock::now() + wait_time);
+            break;
+        case Result::FINISHED:
+            active_ = false;
+            pending_ = false;
+            break;
+    }
+    cond_var_.notify_all();
 }
 
-void DataReader::read_task(
-        dds::xrce::DataDeliveryControl delivery_control,
-        read_callback read_cb,
-        ReadCallbackArgs cb_args)
+DataReader::Delivery::Result DataReader::Delivery::deliver(std::chrono::milliseconds& wait_time)
 {
-    size_t rate = (MAX_BYTES_PER_SECOND_UNLIMITED == delivery_control.max_bytes_per_second())
-            ? SIZE_MAX
-            : delivery_control.max_bytes_per_second();
-    TokenBucket token_bucket{rate};
-    bool stop_cond = false;
-    uint16_t message_count = 0;
-    std::chrono::time_point<std::chrono::steady_clock> init_time
-            = std::chrono::steady_clock::now();
-    const std::chrono::time_point<std::chrono::steady_clock> final_time
-            = init_time + std::chrono::seconds(delivery_control.max_elapsed_time());
-    std::vector<uint8_t> data;
-    while (running_cond_ && !stop_cond)
+    /* Bounded amount of messages per task, so a busy reader does not starve the others. */
+    for (size_t i = 0; i < MAX_SAMPLES_PER_TASK; ++i)
     {
-        std::chrono::milliseconds read_timeout = get_read_timeout(final_time, delivery_control.max_elapsed_time());
-        if (get_middleware().read_data(get_raw_id(), data, read_timeout))
+        if ((MAX_ELAPSED_TIME_UNLIMITED != delivery_control_.max_elapsed_time()) &&
+            (std::chrono::steady_clock::now() > final_time_))
         {
-            std::chrono::milliseconds wait_time = token_bucket.wait_time(data.size());
-            while (running_cond_ && wait_time.count())
+            return Result::FINISHED;
+        }
+
+        /* Samples lent by the middleware are serialized once, straight into the pooled tail of the message. */
+        std::shared_ptr<std::vector<uint8_t>> buffer = OutputMessage::acquire_tail();
+        SampleBatch batch(cb_args_.data_format, cb_args_.max_data_size, std::move(*buffer));
+        Result result = Result::PENDING;
+        bool loaned = true;
+        Middleware::OnDataLoan on_loan = [&](const ByteView& sample)
+        {
+            result = take_sample(batch, sample, wait_time);
+        };
+        while (loaned && (Result::PENDING == result) && batch.fits(0) && !is_complete() &&
+               !(has_data_ && (0 != batch.get_count())))
+        {
+            /* A sample kept from the previous message goes first. */
+            if (has_data_)
             {
-                std::this_thread::sleep_for(std::min(std::chrono::milliseconds(MAX_SLEEP_TIME), wait_time));
-                wait_time = token_bucket.wait_time(data.size());
+                has_data_ = false;
+                on_loan(ByteView(data_));
             }
+            else
+            {
+                loaned = middleware_.loan_data(raw_id_, on_loan);
+            }
+        }
 
-            if (token_bucket.get_tokens(data.size()))
+        const size_t count = batch.get_count();
+        *buffer = batch.release();
+        if (0 != count)
+        {
+            read_cb_(cb_args_, std::move(buffer));
+
+            /* The callback may have stopped the delivery, even destroyed the middleware along with the reader. */
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (!active_)
             {
-                UXR_AGENT_LOG_MESSAGE(
-                    UXR_DECORATE_YELLOW("[==>> DDS <<==]"),
-                    get_raw_id(),
-                    data.data(),
-                    data.size());
-                read_cb(cb_args, data);
-                ++message_count;
+                return Result::FINISHED;
             }
         }
 
-        stop_cond = ((MAX_SAMPLES_UNLIMITED != delivery_control.max_samples()) &&
-                     (message_count == delivery_control.max_samples())) ||
-                    ((MAX_ELAPSED_TIME_UNLIMITED != delivery_control.max_elapsed_time()) &&
-                     (std::chrono::steady_clock::now() > final_time));
+        if (Result::PENDING != result)
+        {
+            return result;
+        }
+
+        if (is_complete())
+        {
+            return Result::FINISHED;
+        }
+
+        if (!loaned)
+        {
+            return Result::DRAINED;
+        }
+    }
+    return Result::PENDING;
+}
+
+DataReader::Delivery::Result DataReader::Delivery::take_sample(
+        SampleBatch& batch,
+        const ByteView& sample,
+        std::chrono::milliseconds& wait_time)
+{
+    Result rv = Result::PENDING;
+    if (0 == batch.get_count())
+    {
+        /* The first sample waits for its tokens, once its wait is over it is delivered rather than lost. */
+        wait_time = token_bucket_.wait_time(sample.size());
+        if (0 != wait_time.count())
+        {
+            keep_sample(sample);
+            rv = Result::THROTTLED;
+        }
+        else
+        {
+            token_bucket_.get_tokens(sample.size());
+            append_sample(batch, sample);
+        }
+    }
+    else if (batch.fits(sample.size()) && token_bucket_.get_tokens(sample.size()))
+    {
+        append_sample(batch, sample);
+    }
+    else
+    {
+        /* A sample which does not fit, or is throttled, is kept for the next message. */
+        keep_sample(sample);
+    }
+    return rv;
+}
+
+void DataReader::Delivery::append_sample(
+        SampleBatch& batch,
+        const ByteView& sample)
+{
+    UXR_AGENT_LOG_MESSAGE(
+        UXR_DECORATE_YELLOW("[==>> DDS <<==]"),
+        raw_id_,
+        sample.data(),
+        sample.size());
+
+    const std::chrono::milliseconds time_offset =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time_);
+    batch.append(sample, sequence_number_, uint32_t(time_offset.count()));
+    ++message_count_;
+    ++sequence_number_;
+}
+
+void DataReader::Delivery::keep_sample(const ByteView& sample)
+{
+    /* Only copied when lent, the kept sample may be delivered from data_ itself. */
+    if (sample.data() != data_.data())
+    {
+        data_.assign(sample.begin(), sample.end());
+    }
+    has_data_ = true;
+}
+
+bool DataReader::Delivery::is_complete() const
+{
+    return (MAX_SAMPLES_UNLIMITED != delivery_control_.max_samples()) &&
+           (message_count_ >= delivery_control_.max_samples());
+}
+
+void DataReader::Delivery::post()
+{
+    std::weak_ptr<Delivery> weak_delivery(shared_from_this());
+    get_delivery_executor().post([weak_delivery]()
+    {
+        if (std::shared_ptr<Delivery> delivery = weak_delivery.lock())
+        {
+            delivery->run();
+        }
+    });
+}
+
+void DataReader::Delivery::post_at(DeliveryExecutor::TimePoint time_point)
+{
+    std::weak_ptr<Delivery> weak_delivery(shared_from_this());
+    get_delivery_executor().post_at(time_point, [weak_delivery]()
+    {
+        if (std::shared_ptr<Delivery> delivery = weak_delivery.lock())
+        {
+            delivery->run();
+        }
+    });
+}
+
+/**********************************************************************************************************************
+ * DataReader
+ **********************************************************************************************************************/
+bool DataReader::start_read(
+        const dds::xrce::DataDeliveryControl& delivery_control,
+        read_callback read_cb,
+        const ReadCallbackArgs& cb_args)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    delivery_ = std::make_shared<Delivery>(get_middleware(), get_raw_id(), delivery_control, read_cb, cb_args);
+
+    std::weak_ptr<Delivery> weak_delivery(delivery_);
+    get_middleware().set_on_data_available(get_raw_id(), [weak_delivery]()
+    {
+        if (std::shared_ptr<Delivery> delivery = weak_delivery.lock())
+        {
+            delivery->notify();
+        }
+    });
+    delivery_->start();
+    return true;
+}
+
+bool DataReader::stop_read()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (delivery_)
+    {
+        get_middleware().set_on_data_available(get_raw_id(), nullptr);
+        delivery_->stop();
+        delivery_.reset();
     }
+    return true;
 }
 
 } // namespace uxr
@@ -113,31 +113,34 @@ bool DataWriter::matched(const dds::xrce::ObjectVariant& new_object_rep) const
     return rv;
 }
 
-bool DataWriter::write(dds::xrce::WRITE_DATA_Payload_Data& write_data)
+bool DataWriter::write(const ByteView& data)
 {
     bool rv = false;
-    if (get_middleware().write_data(get_raw_id(), write_data.data().serialized_data()))
+    if (get_middleware().write_data(get_raw_id(), data))
     {
         UXR_AGENT_LOG_MESSAGE(
             UXR_DECORATE_YELLOW("[** <<DDS>> **]"),
             get_raw_id(),
-            write_data.data().serialized_data().data(),
-            write_data.data().serialized_data().size());
+            data.data(),
+            data.size());
         rv = true;
     }
     return rv;
 }
 
-bool DataWriter::write(const std::vector<uint8_t>& data)
+bool DataWriter::write_batch(const std::vector<ByteView>& batch)
 {
     bool rv = false;
-    if (get_middleware().write_data(get_raw_id(), data))
+    if (get_middleware().write_data_batch(get_raw_id(), batch))
     {
-        UXR_AGENT_LOG_MESSAGE(
-            UXR_DECORATE_YELLOW("[** <<DDS>> **]"),
-            get_raw_id(),
-            data.data(),
-            data.size());
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            UXR_AGENT_LOG_MESSAGE(
+                UXR_DECORATE_YELLOW("[** <<DDS>> **]"),
+                get_raw_id(),
+                batch[i].data(),
+                batch[i].size());
+        }
         rv = true;
     }
     return rv;
@@ -14,16 +14,24 @@
 
 #include <uxr/agent/message/InputMessage.hpp>
 #include <uxr/agent/logger/Logger.hpp>
+#include <uxr/agent/config.hpp>
 
 namespace eprosima {
 namespace uxr {
 
+PooledBuffer InputMessage::acquire_buffer(size_t len)
+{
+    /* Never destroyed, buffers may be released by threads or static agents outliving static destruction. */
+    static BufferPool& pool = *new BufferPool(INPUT_BUFFER_SIZE, INPUT_BUFFER_POOL_SIZE);
+    return (len <= pool.get_buffer_size()) ? pool.acquire() : PooledBuffer(len);
+}
+
 void InputMessage::log_error()
 {
     UXR_AGENT_LOG_ERROR(
         UXR_DECORATE_RED("deserialization error"),
         "buffer: {:X}",
-        UXR_AGENT_LOG_TO_HEX(buf_, buf_ + len_));
+        UXR_AGENT_LOG_TO_HEX(buffer_.get(), buffer_.get() + len_));
 }
 
 } // namespace uxr
@@ -14,16 +14,53 @@
 
 #include <uxr/agent/message/OutputMessage.hpp>
 #include <uxr/agent/logger/Logger.hpp>
+#include <uxr/agent/config.hpp>
 
 namespace eprosima {
 namespace uxr {
 
+/* Power of two size classes, from 64 B up to the largest datagram. */
+const size_t MIN_OUTPUT_BUFFER_SIZE = 64;
+const size_t OUTPUT_BUFFER_SIZE_CLASSES = 11;
+
+static std::vector<std::unique_ptr<BufferPool>> create_pools()
+{
+    std::vector<std::unique_ptr<BufferPool>> pools;
+    for (size_t i = 0; i < OUTPUT_BUFFER_SIZE_CLASSES; ++i)
+    {
+        pools.emplace_back(new BufferPool(MIN_OUTPUT_BUFFER_SIZE << i, OUTPUT_BUFFER_POOL_SIZE));
+    }
+    return pools;
+}
+
+PooledBuffer OutputMessage::acquire_buffer(size_t len)
+{
+    /* Never destroyed, buffers may be released by threads or static agents outliving static destruction. */
+    static std::vector<std::unique_ptr<BufferPool>>& pools = *new std::vector<std::unique_ptr<BufferPool>>(create_pools());
+    for (auto& pool : pools)
+    {
+        if (len <= pool->get_buffer_size())
+        {
+            return pool->acquire();
+        }
+    }
+    return PooledBuffer(len);
+}
+
+std::shared_ptr<std::vector<uint8_t>> OutputMessage::acquire_tail()
+{
+    /* Samples larger than the largest size class are not worth caching. The pool is never destroyed either. */
+    static SampleBufferPool& pool =
+            *new SampleBufferPool(MIN_OUTPUT_BUFFER_SIZE << (OUTPUT_BUFFER_SIZE_CLASSES - 1), OUTPUT_BUFFER_POOL_SIZE);
+    return pool.acquire();
+}
+
 void OutputMessage::log_error()
 {
     UXR_AGENT_LOG_ERROR(
         UXR_DECORATE_RED("serialization error"),
         "buffer: {:X}",
-        UXR_AGENT_LOG_TO_HEX(buf_, buf_ + len_));
+        UXR_AGENT_LOG_TO_HEX(buffer_.get(), buffer_.get() + len_));
 }
 
 } // namespace uxr
@@ -156,7 +156,7 @@ const std::string& CedGlobalTopic::name() const
 }
 
 bool CedGlobalTopic::write(
-        const std::vector<uint8_t>& data,
+        const ByteView& data,
         WriteAccess write_access,
         TopicSource topic_src,
         uint8_t& errcode)
@@ -166,19 +166,59 @@ bool CedGlobalTopic::write(
     {
         std::unique_lock<std::mutex> lock(mtx_);
         size_t index = uint16_t(last_write_ + 1) % history_.size();
-        history_[index] = data;
+        history_[index].assign(data.begin(), data.end());
         srcs_[index] = topic_src;
         ++last_write_;
         lock.unlock();
         cv_.notify_all();
+
+        notify_listeners();
         errcode = 0;
         rv = true;
     }
     return rv;
 }
 
+bool CedGlobalTopic::write_batch(
+        const std::vector<ByteView>& batch,
+        WriteAccess write_access,
+        TopicSource topic_src,
+        uint8_t& errcode)
+{
+    bool rv = false;
+    if (check_write_access(write_access, topic_src))
+    {
+        /* Readers slower than the history lose the oldest samples, as with single writes. */
+        std::unique_lock<std::mutex> lock(mtx_);
+        for (const auto& data : batch)
+        {
+            size_t index = uint16_t(last_write_ + 1) % history_.size();
+            history_[index].assign(data.begin(), data.end());
+            srcs_[index] = topic_src;
+            ++last_write_;
+        }
+        lock.unlock();
+        cv_.notify_all();
+
+        notify_listeners();
+        errcode = 0;
+        rv = true;
+    }
+    return rv;
+}
+
+void CedGlobalTopic::notify_listeners()
+{
+    /* Notify the event-driven readers. */
+    std::lock_guard<std::mutex> listeners_lock(listeners_mtx_);
+    for (auto& listener : listeners_)
+    {
+        listener.second();
+    }
+}
+
 bool CedGlobalTopic::read(
-        std::vector<uint8_t>& data,
+        const Middleware::OnDataLoan& on_loan,
         std::chrono::milliseconds timeout,
         SeqNum& last_read,
         ReadAccess read_access,
@@ -197,7 +237,7 @@ bool CedGlobalTopic::read(
         /* Try to read data without timeout. */
         do
         {
-            rv = get_data(data, last_read, read_access);
+            rv = get_data(on_loan, last_read, read_access);
         } while(!rv && (last_read != last_write_));
     }
 
@@ -206,7 +246,7 @@ bool CedGlobalTopic::read(
         /* Try to read data with timeout in case. */
         auto now = std::chrono::steady_clock::now();
         if (cv_.wait_until(lock, now + std::chrono::milliseconds(timeout), [&](){
-                           return last_read != last_write_ && get_data(data, last_read, read_access); }))
+                           return last_read != last_write_ && get_data(on_loan, last_read, read_access); }))
         {
             rv = true;
         }
@@ -238,7 +278,7 @@ bool CedGlobalTopic::check_read_access(
 }
 
 bool CedGlobalTopic::get_data(
-        std::vector<uint8_t>& data,
+        const Middleware::OnDataLoan& on_loan,
         SeqNum& last_read,
         ReadAccess read_access)
 {
@@ -246,12 +286,26 @@ bool CedGlobalTopic::get_data(
     size_t index = uint16_t(++last_read) % history_.size();
     if (check_read_access(read_access, index))
     {
-        data.assign(history_[index].begin(), history_[index].end());
+        on_loan(ByteView(history_[index]));
         rv = true;
     }
     return rv;
 }
 
+void CedGlobalTopic::set_listener(
+        const CedDataReader* datareader,
+        Middleware::OnDataAvailable on_data_available)
+{
+    std::lock_guard<std::mutex> lock(listeners_mtx_);
+    if (on_data_available)
+    {
+        listeners_[datareader] = std::move(on_data_available);
+    }
+    else
+    {
+        listeners_.erase(datareader);
+    }
+}
 
 /**********************************************************************************************************************
  * CedParticipant
@@ -317,21 +371,48 @@ CedGlobalTopic* CedTopic::global_topic() const
  * CedDataWriter
  **********************************************************************************************************************/
 bool CedDataWriter::write(
-        const std::vector<uint8_t>& data,
+        const ByteView& data,
         uint8_t& errcode) const
 {
     return topic_->global_topic()->write(data, write_access_, topic_src_, errcode);
 }
 
+bool CedDataWriter::write_batch(
+        const std::vector<ByteView>& batch,
+        uint8_t& errcode) const
+{
+    return topic_->global_topic()->write_batch(batch, write_access_, topic_src_, errcode);
+}
+
 /**********************************************************************************************************************
  * CedDataReader
  **********************************************************************************************************************/
+CedDataReader::~CedDataReader()
+{
+    topic_->global_topic()->set_listener(this, nullptr);
+}
+
 bool CedDataReader::read(
         std::vector<uint8_t>& data,
         std::chrono::milliseconds timeout,
         uint8_t &errcode)
 {
-    return topic_->global_topic()->read(data, timeout, last_read_, read_access_, errcode);
+    return topic_->global_topic()->read([&data](const ByteView& sample)
+    {
+        data.assign(sample.begin(), sample.end());
+    }, timeout, last_read_, read_access_, errcode);
+}
+
+bool CedDataReader::loan(
+        const Middleware::OnDataLoan& on_loan,
+        uint8_t& errcode)
+{
+    return topic_->global_topic()->read(on_loan, std::chrono::milliseconds(0), last_read_, read_access_, errcode);
+}
+
+void CedDataReader::set_on_data_available(Middleware::OnDataAvailable on_data_available)
+{
+    topic_->global_topic()->set_listener(this, std::move(on_data_available));
 }
 
 } // namespace uxr
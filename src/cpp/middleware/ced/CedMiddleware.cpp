@@ -348,7 +348,7 @@ bool CedMiddleware::delete_datareader(uint16_t datareader_id)
  **********************************************************************************************************************/
 bool CedMiddleware::write_data(
         uint16_t datawriter_id,
-        const std::vector<uint8_t>& data)
+        const ByteView& data)
 {
     bool rv = false;
     auto it = datawriters_.find(datawriter_id);
@@ -360,6 +360,20 @@ bool CedMiddleware::write_data(
     return rv;
 }
 
+bool CedMiddleware::write_data_batch(
+        uint16_t datawriter_id,
+        const std::vector<ByteView>& batch)
+{
+    bool rv = false;
+    auto it = datawriters_.find(datawriter_id);
+    if (datawriters_.end() != it)
+    {
+        uint8_t errcode;
+        rv = it->second->write_batch(batch, errcode);
+    }
+    return rv;
+}
+
 bool CedMiddleware::read_data(
         uint16_t datareader_id,
         std::vector<uint8_t>& data,
@@ -375,6 +389,34 @@ bool CedMiddleware::read_data(
     return rv;
 }
 
+bool CedMiddleware::loan_data(
+        uint16_t datareader_id,
+        const OnDataLoan& on_loan)
+{
+    bool rv = false;
+    auto it = datareaders_.find(datareader_id);
+    if (datareaders_.end() != it)
+    {
+        uint8_t errcode;
+        rv = it->second->loan(on_loan, errcode);
+    }
+    return rv;
+}
+
+bool CedMiddleware::set_on_data_available(
+        uint16_t datareader_id,
+        OnDataAvailable on_data_available)
+{
+    bool rv = false;
+    auto it = datareaders_.find(datareader_id);
+    if (datareaders_.end() != it)
+    {
+        it->second->set_on_data_available(std::move(on_data_available));
+        rv = true;
+    }
+    return rv;
+}
+
 /**********************************************************************************************************************
  * Matched functions.
  **********************************************************************************************************************/
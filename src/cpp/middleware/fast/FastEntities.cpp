@@ -246,9 +246,11 @@ bool FastDataWriter::match_from_xml(const std::string& xml) const
     return rv;
 }
 
-bool FastDataWriter::write(const std::vector<uint8_t>& data)
+bool FastDataWriter::write(const ByteView& data)
 {
-    return ptr_->write(&const_cast<std::vector<uint8_t>&>(data));
+    /* Serialized by TopicPubSubType straight from the view. */
+    TopicSample sample{data, nullptr};
+    return ptr_->write(&sample);
 }
 
 void FastDataWriter::onPublicationMatched(
@@ -342,11 +344,13 @@ bool FastDataReader::read(
 {
     auto now = std::chrono::steady_clock::now();
     bool rv = false;
+    Middleware::OnDataLoan copy_data = [&data](const ByteView& sample)
+    {
+        data.assign(sample.begin(), sample.end());
+    };
     if (unread_count_ != 0)
     {
-        fastrtps::SampleInfo_t info;
-        rv = ptr_->takeNextData(&data, &info);
-        unread_count_ = ptr_->getUnreadCount();
+        rv = loan(copy_data);
     }
     else
     {
@@ -354,14 +358,32 @@ bool FastDataReader::read(
         if (cv_.wait_until(lock, now + timeout, [&](){ return unread_count_ != 0; }))
         {
             lock.unlock();
-            fastrtps::SampleInfo_t info;
-            rv = ptr_->takeNextData(&data, &info);
-            unread_count_ = ptr_->getUnreadCount();
+            rv = loan(copy_data);
         }
     }
     return rv;
 }
 
+bool FastDataReader::loan(const Middleware::OnDataLoan& on_loan)
+{
+    /* TopicPubSubType lends the payload of the taken change, changes without data are taken and skipped. */
+    bool loaned = false;
+    Middleware::OnDataLoan take_data = [&on_loan, &loaned](const ByteView& sample)
+    {
+        on_loan(sample);
+        loaned = true;
+    };
+    TopicSample sample{ByteView(), &take_data};
+    fastrtps::SampleInfo_t info;
+    bool taken = true;
+    while (taken && !loaned && (0 != unread_count_))
+    {
+        taken = ptr_->takeNextData(&sample, &info);
+        unread_count_ = ptr_->getUnreadCount();
+    }
+    return loaned;
+}
+
 void FastDataReader::onSubscriptionMatched(
         fastrtps::Subscriber*,
         fastrtps::rtps::MatchingInfo& info)
@@ -384,11 +406,21 @@ void FastDataReader::onSubscriptionMatched(
     }
 }
 
+void FastDataReader::set_on_data_available(Middleware::OnDataAvailable on_data_available)
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    on_data_available_ = std::move(on_data_available);
+}
+
 void FastDataReader::onNewDataMessage(fastrtps::Subscriber *)
 {
     unread_count_ = ptr_->getUnreadCount();
     std::unique_lock<std::mutex> lock(mtx_);
     cv_.notify_one();
+    if (on_data_available_)
+    {
+        on_data_available_();
+    }
 }
 
 } // namespace uxr
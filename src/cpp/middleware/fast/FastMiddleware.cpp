@@ -251,7 +251,7 @@ bool FastMiddleware::delete_datareader(uint16_t datareader_id)
  **********************************************************************************************************************/
 bool FastMiddleware::write_data(
         uint16_t datawriter_id,
-        const std::vector<uint8_t>& data)
+        const ByteView& data)
 {
     bool rv = false;
     auto it = datawriters_.find(datawriter_id);
@@ -262,6 +262,23 @@ bool FastMiddleware::write_data(
     return rv;
 }
 
+bool FastMiddleware::write_data_batch(
+        uint16_t datawriter_id,
+        const std::vector<ByteView>& batch)
+{
+    bool rv = false;
+    auto it = datawriters_.find(datawriter_id);
+    if (datawriters_.end() != it)
+    {
+        rv = true;
+        for (const auto& data : batch)
+        {
+            rv = it->second->write(data) && rv;
+        }
+    }
+    return rv;
+}
+
 bool FastMiddleware::read_data(
         uint16_t datareader_id,
         std::vector<uint8_t>& data,
@@ -277,6 +294,33 @@ bool FastMiddleware::read_data(
     return rv;
 }
 
+bool FastMiddleware::loan_data(
+        uint16_t datareader_id,
+        const OnDataLoan& on_loan)
+{
+    bool rv = false;
+    auto it = datareaders_.find(datareader_id);
+    if (datareaders_.end() != it)
+    {
+        rv = it->second->loan(on_loan);
+    }
+    return rv;
+}
+
+bool FastMiddleware::set_on_data_available(
+        uint16_t datareader_id,
+        OnDataAvailable on_data_available)
+{
+    bool rv = false;
+    auto it = datareaders_.find(datareader_id);
+    if (datareaders_.end() != it)
+    {
+        it->second->set_on_data_available(std::move(on_data_available));
+        rv = true;
+    }
+    return rv;
+}
+
 /**********************************************************************************************************************
  * Matched functions.
  **********************************************************************************************************************/
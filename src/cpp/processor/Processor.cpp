@@ -15,13 +15,25 @@
 #include <uxr/agent/processor/Processor.hpp>
 #include <uxr/agent/datawriter/DataWriter.hpp>
 #include <uxr/agent/datareader/DataReader.hpp>
+#include <uxr/agent/datareader/SampleBatch.hpp>
 #include <uxr/agent/Root.hpp>
 #include <uxr/agent/transport/Server.hpp>
 #include <uxr/agent/utils/Time.hpp>
 
+#include <algorithm>
+
 namespace eprosima {
 namespace uxr {
 
+/* The builtin streams carry the replies to the client requests, the rest carry data. */
+static OutputPriority get_output_priority(dds::xrce::StreamId stream_id)
+{
+    return ((dds::xrce::STREAMID_BUILTIN_RELIABLE == stream_id) ||
+            (dds::xrce::STREAMID_BUILTIN_BEST_EFFORTS == stream_id))
+           ? CONTROL_OUTPUT_PRIORITY
+           : DATA_OUTPUT_PRIORITY;
+}
+
 Processor::Processor(
         Server& server,
         Root& root,
@@ -29,6 +41,12 @@ Processor::Processor(
     : server_(server)
     , middleware_kind_{middleware_kind}
     , root_(root)
+    , timer_mtx_()
+    , timer_cv_()
+    , timers_{utils::TimerWheel::to_tick(std::chrono::steady_clock::now())}
+    , timer_wakeup_{utils::TimerWheel::NEVER}
+    , expired_timers_()
+    , coalescing_window_(0)
 {}
 
 Processor::~Processor()
@@ -102,7 +120,7 @@ void Processor::process_input_packet(InputPacket&& input_packet)
                 output_packet.message->append_submessage(dds::xrce::ACKNACK, acknack_payload);
 
                 /* Send message. */
-                server_.push_output_packet(output_packet);
+                server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
             }
         }
     }
@@ -210,6 +228,11 @@ bool Processor::process_create_client_submessage(InputPacket& input_packet)
             {
                 server_.on_create_client(input_packet.source.get(),
                                           client_payload.client_representation());
+                if (std::shared_ptr<ProxyClient> client =
+                        root_.get_client(client_payload.client_representation().client_key()))
+                {
+                    client->set_source(input_packet.source);
+                }
             }
             /* STATUS_AGENT payload. */
             dds::xrce::STATUS_AGENT_Payload status_agent;
@@ -234,7 +257,7 @@ bool Processor::process_create_client_submessage(InputPacket& input_packet)
             output_packet.message->append_submessage(dds::xrce::STATUS_AGENT, status_agent);
 
             /* Send message. */
-            server_.push_output_packet(output_packet);
+            server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
         }
     }
     else
@@ -267,6 +290,7 @@ bool Processor::process_create_submessage(
 
         /* Push submessage into the output stream. */
         client.session().push_output_submessage(dds::xrce::STREAMID_BUILTIN_RELIABLE, dds::xrce::STATUS, status_payload);
+        arm_heartbeat(client, dds::xrce::STREAMID_BUILTIN_RELIABLE);
 
         /* Set output packet. */
         OutputPacket output_packet;
@@ -274,7 +298,7 @@ bool Processor::process_create_submessage(
         while (client.session().get_next_output_message(dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet.message))
         {
             /* Send status. */
-            server_.push_output_packet(output_packet);
+            server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
         }
     }
     return rv;
@@ -311,7 +335,7 @@ bool Processor::process_delete_submessage(
             if (client.session().get_next_output_message(dds::xrce::STREAMID_NONE, output_packet.message))
             {
                 /* Send message. */
-                server_.push_output_packet(output_packet);
+                server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
             }
         }
         else
@@ -321,10 +345,11 @@ bool Processor::process_delete_submessage(
 
             /* Store message. */
             client.session().push_output_submessage(dds::xrce::STREAMID_BUILTIN_RELIABLE, dds::xrce::STATUS, status_payload);
+            arm_heartbeat(client, dds::xrce::STREAMID_BUILTIN_RELIABLE);
             while (client.session().get_next_output_message(dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet.message))
             {
                 /* Send message. */
-                server_.push_output_packet(output_packet);
+                server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
             }
         }
     }
@@ -344,26 +369,49 @@ bool Processor::process_write_data_submessage(
     bool deserialized = false, written = false;
     uint8_t flags = input_packet.message->get_subheader().flags() & 0x0E;
     uint16_t submessage_length = input_packet.message->get_subheader().submessage_length();
-    switch (flags)
+
+    /* The samples are handed to the middleware as views of the input message, which outlives the write. */
+    dds::xrce::BaseObjectRequest request;
+    ByteView payload;
+    if ((request.getCdrSerializedSize(0) <= submessage_length) &&
+        input_packet.message->get_payload(request) &&
+        input_packet.message->get_payload_view(payload, submessage_length - request.getCdrSerializedSize(0)))
     {
-        case dds::xrce::FORMAT_DATA_FLAG:
+        switch (flags)
         {
-            dds::xrce::WRITE_DATA_Payload_Data data_payload;
-            data_payload.data().resize(submessage_length - data_payload.BaseObjectRequest::getCdrSerializedSize(0));
-            if (input_packet.message->get_payload(data_payload))
+            case dds::xrce::FORMAT_DATA_FLAG:
             {
-                std::shared_ptr<DataWriter> data_writer =
-                        std::dynamic_pointer_cast<DataWriter>(client.get_object(data_payload.object_id()));
+                std::shared_ptr<DataWriter> data_writer = client.get_datawriter(request.object_id());
                 if (nullptr != data_writer)
                 {
-                    written = data_writer->write(data_payload);
+                    written = data_writer->write(payload);
                 }
                 deserialized = true;
+                break;
             }
-            break;
+            case dds::xrce::FORMAT_SAMPLE_FLAG:
+            case dds::xrce::FORMAT_DATA_SEQ_FLAG:
+            case dds::xrce::FORMAT_SAMPLE_SEQ_FLAG:
+            case dds::xrce::FORMAT_PACKED_SAMPLES_FLAG:
+            {
+                /* The samples following the BaseObjectRequest are split and written in a single call. */
+                std::vector<ByteView> samples;
+                const bool little_endian =
+                        (0 != (input_packet.message->get_subheader().flags() & dds::xrce::FLAG_LITTLE_ENDIANNESS));
+                if (SampleBatch::deserialize(flags, payload, little_endian, samples))
+                {
+                    std::shared_ptr<DataWriter> data_writer = client.get_datawriter(request.object_id());
+                    if (nullptr != data_writer)
+                    {
+                        written = data_writer->write_batch(samples);
+                    }
+                    deserialized = true;
+                }
+                break;
+            }
+            default:
+                break;
         }
-        default:
-            break;
     }
 
     if (!deserialized)
@@ -389,8 +437,7 @@ bool Processor::process_read_data_submessage(
     dds::xrce::READ_DATA_Payload read_payload;
     if (input_packet.message->get_payload(read_payload))
     {
-        std::shared_ptr<DataReader> data_reader =
-                std::dynamic_pointer_cast<DataReader>(client.get_object(read_payload.object_id()));
+        std::shared_ptr<DataReader> data_reader = client.get_datareader(read_payload.object_id());
         dds::xrce::StatusValue status = (nullptr != data_reader) ? dds::xrce::STATUS_OK
                                                                  : dds::xrce::STATUS_ERR_UNKNOWN_REFERENCE;
         if (dds::xrce::STATUS_OK == status)
@@ -401,6 +448,16 @@ bool Processor::process_read_data_submessage(
             cb_args.stream_id = read_payload.read_specification().preferred_stream_id();
             cb_args.object_id = read_payload.object_id();
             cb_args.request_id = read_payload.request_id();
+            cb_args.data_format = dds::xrce::FORMAT_DATA;
+
+            /* Batched samples fill the DATA submessage up to the MTU. */
+            dds::xrce::MessageHeader data_header;
+            data_header.session_id(client.get_session_id());
+            const size_t headers_size = data_header.getCdrSerializedSize() +
+                                        dds::xrce::SubmessageHeader().getCdrSerializedSize() +
+                                        dds::xrce::BaseObjectRequest().getCdrSerializedSize();
+            const size_t mtu = client.session().get_mtu();
+            cb_args.max_data_size = (headers_size < mtu) ? (mtu - headers_size) : 0;
 
             /* Launch read data. */
             using namespace std::placeholders;
@@ -421,6 +478,7 @@ bool Processor::process_read_data_submessage(
 
             /* Push submessage into the output stream. */
             client.session().push_output_submessage(dds::xrce::STREAMID_BUILTIN_RELIABLE, dds::xrce::STATUS, status_payload);
+            arm_heartbeat(client, dds::xrce::STREAMID_BUILTIN_RELIABLE);
 
             /* Set output packet. */
             OutputPacket output_packet;
@@ -428,7 +486,7 @@ bool Processor::process_read_data_submessage(
             while (client.session().get_next_output_message(dds::xrce::STREAMID_BUILTIN_RELIABLE, output_packet.message))
             {
                 /* Send message. */
-                server_.push_output_packet(output_packet);
+                server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
             }
         }
     }
@@ -452,6 +510,7 @@ bool Processor::process_acknack_submessage(
         uint16_t first_message = acknack_payload.first_unacked_seq_num();
         std::array<uint8_t, 2> nack_bitmap = acknack_payload.nack_bitmap();
         uint8_t stream_id = acknack_payload.stream_id();
+        const OutputPriority priority = get_output_priority(stream_id);
         for (uint16_t i = 0; i < 8; ++i)
         {
             OutputPacket output_packet;
@@ -461,20 +520,21 @@ bool Processor::process_acknack_submessage(
             {
                 if (client.session().get_output_message(stream_id, first_message + i, output_packet.message))
                 {
-                    server_.push_output_packet(output_packet);
+                    server_.push_output_packet(output_packet, priority);
                 }
             }
             if ((nack_bitmap.at(0) & mask) == mask)
             {
                 if (client.session().get_output_message(stream_id, first_message + i + 8, output_packet.message))
                 {
-                    server_.push_output_packet(output_packet);
+                    server_.push_output_packet(output_packet, priority);
                 }
             }
         }
 
         /* Update output stream. */
         client.session().update_from_acknack(stream_id, first_message);
+        restart_heartbeat(client, stream_id);
     }
     else
     {
@@ -512,7 +572,7 @@ bool Processor::process_heartbeat_submessage(
         if (client.session().get_next_output_message(dds::xrce::STREAMID_NONE, output_packet.message))
         {
             /* Send message. */
-            server_.push_output_packet(output_packet);
+            server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
         }
     }
     else
@@ -565,7 +625,7 @@ bool Processor::process_timestamp_submessage(ProxyClient& client, InputPacket& i
         output_packet.destination = input_packet.source;
         if (client.session().get_next_output_message(dds::xrce::STREAMID_NONE, output_packet.message))
         {
-            server_.push_output_packet(output_packet);
+            server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
         }
     }
     else
@@ -621,29 +681,38 @@ bool Processor::process_timestamp_submessage(ProxyClient& client, InputPacket& i
 
 void Processor::read_data_callback(
         const ReadCallbackArgs& cb_args,
-        const std::vector<uint8_t>& buffer)
+        std::shared_ptr<const std::vector<uint8_t>> buffer)
 {
     std::shared_ptr<ProxyClient> client = root_.get_client(cb_args.client_key);
 
-    /* DATA payload. */
-    dds::xrce::DATA_Payload_Data data_payload;
-    data_payload.request_id(cb_args.request_id);
-    data_payload.object_id(cb_args.object_id);
-    data_payload.data().serialized_data(buffer);
+    /* DATA payload, the samples in the requested format are carried as a scattered tail instead of being copied. */
+    dds::xrce::BaseObjectRequest data_request;
+    data_request.request_id(cb_args.request_id);
+    data_request.object_id(cb_args.object_id);
+    ScatteredSubmessage<dds::xrce::BaseObjectRequest> data_payload{
+        data_request,
+        std::move(buffer),
+        cb_args.data_format};
 
     /* Set output packet and serialize DATA. */
     OutputPacket output_packet;
-    output_packet.destination = server_.get_source(cb_args.client_key);
-    if (output_packet.destination)
+    if (client && (output_packet.destination = client->get_source()))
     {
-        /* Push submessage into the output stream. */
-        client->session().push_output_submessage(cb_args.stream_id, dds::xrce::DATA, data_payload);
+        /* Push submessage into the output stream, packed with the previous ones within the coalescing window. */
+        const bool coalesce = (std::chrono::milliseconds(0) < coalescing_window_);
+        client->session().push_output_submessage(cb_args.stream_id, dds::xrce::DATA, data_payload, coalesce);
+        arm_heartbeat(*client, cb_args.stream_id);
 
-        /* Set output message. */
-        while (client->session().get_next_output_message(cb_args.stream_id, output_packet.message))
+        /* Set output message, the open one is sent once full or by its flush timer. */
+        while (client->session().get_next_output_message(cb_args.stream_id, output_packet.message, !coalesce))
         {
             /* Send message. */
-            server_.push_output_packet(output_packet);
+            server_.push_output_packet(output_packet, DATA_OUTPUT_PRIORITY);
+        }
+
+        if (coalesce)
+        {
+            arm_flush(*client, cb_args.stream_id);
         }
     }
 }
@@ -706,50 +775,188 @@ bool Processor::process_get_info_packet(
     return rv;
 }
 
-void Processor::check_heartbeats()
+void Processor::check_timers(
+        std::chrono::milliseconds max_wait)
 {
-    /* HEARTBEAT header. */
-    dds::xrce::MessageHeader header;
-    header.stream_id(dds::xrce::STREAMID_NONE);
-    header.sequence_nr(0x00);
+    std::unique_lock<std::mutex> lock(timer_mtx_);
+    const utils::TimerWheel::Tick max_wakeup =
+            utils::TimerWheel::to_tick(std::chrono::steady_clock::now()) + utils::TimerWheel::Tick(max_wait.count());
+    timer_wakeup_ = std::min(timers_.next_event(), max_wakeup);
+
+    /* Woken up earlier by a heartbeat or a flush timer scheduled before the wakeup. */
+    timer_cv_.wait_until(lock, utils::TimerWheel::to_time_point(timer_wakeup_));
+    timer_wakeup_ = utils::TimerWheel::NEVER;
+
+    timers_.advance(utils::TimerWheel::to_tick(std::chrono::steady_clock::now()), expired_timers_);
+    std::vector<utils::TimerWheel::Callback> expired;
+    expired.swap(expired_timers_);
+    lock.unlock();
+
+    /* Run outside the lock, heartbeats reschedule themselves. */
+    for (auto& callback : expired)
+    {
+        callback();
+    }
 
-    /* HEARTBEAT payload. */
-    dds::xrce::HEARTBEAT_Payload heartbeat;
+    lock.lock();
+    expired.clear();
+    expired_timers_.swap(expired);
+}
+
+void Processor::arm_heartbeat(
+        ProxyClient& client,
+        uint8_t stream_id)
+{
+    if (client.session().arm_heartbeat(stream_id))
+    {
+        schedule_heartbeat(root_.get_client(client.get_client_key()), stream_id,
+                           client.session().get_heartbeat_period(stream_id));
+    }
+}
+
+void Processor::restart_heartbeat(
+        ProxyClient& client,
+        uint8_t stream_id)
+{
+    /* A timer which is not pending is being run, and it will be scheduled again with the new period. */
+    std::unique_lock<std::mutex> lock(timer_mtx_);
+    if (timers_.cancel(client.session().get_heartbeat_timer(stream_id)))
+    {
+        lock.unlock();
+        if (client.session().rearm_heartbeat(stream_id))
+        {
+            schedule_heartbeat(root_.get_client(client.get_client_key()), stream_id,
+                               client.session().get_heartbeat_period(stream_id));
+        }
+    }
+}
+
+void Processor::schedule_heartbeat(
+        const std::shared_ptr<ProxyClient>& client,
+        uint8_t stream_id,
+        std::chrono::milliseconds period)
+{
+    if (!client)
+    {
+        return;
+    }
+
+    const utils::TimerWheel::Tick deadline =
+            utils::TimerWheel::to_tick(std::chrono::steady_clock::now()) + utils::TimerWheel::Tick(period.count());
+    std::weak_ptr<ProxyClient> weak_client(client);
+    std::lock_guard<std::mutex> lock(timer_mtx_);
+    utils::TimerWheel::TimerId timer_id = timers_.schedule(deadline, [this, weak_client, stream_id]()
+    {
+        send_heartbeat(weak_client, stream_id);
+    });
+    client->session().set_heartbeat_timer(stream_id, timer_id);
+    if (deadline < timer_wakeup_)
+    {
+        timer_cv_.notify_one();
+    }
+}
 
-    /* HEARTBEAT subheader. */
-    dds::xrce::SubmessageHeader subheader;
-    subheader.submessage_id(dds::xrce::HEARTBEAT);
-    subheader.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS);
-    subheader.submessage_length(uint16_t(heartbeat.getCdrSerializedSize()));
+void Processor::send_heartbeat(
+        const std::weak_ptr<ProxyClient>& weak_client,
+        uint8_t stream_id)
+{
+    /* Deleted clients drop their timers. */
+    std::shared_ptr<ProxyClient> client = weak_client.lock();
+    if (!client)
+    {
+        return;
+    }
 
-    const size_t message_size =
-            header.getCdrSerializedSize() +
-            subheader.getCdrSerializedSize() +
-            heartbeat.getCdrSerializedSize();
+    /* HEARTBEAT payload, the timer stops once the stream is acknowledged and backs off otherwise. */
+    dds::xrce::HEARTBEAT_Payload heartbeat;
+    if (!client->session().fill_heartbeat(stream_id, heartbeat))
+    {
+        return;
+    }
 
     OutputPacket output_packet;
+    if ((output_packet.destination = client->get_source()))
+    {
+        /* HEARTBEAT header. */
+        dds::xrce::MessageHeader header;
+        header.session_id(client->get_session_id());
+        header.stream_id(dds::xrce::STREAMID_NONE);
+        header.sequence_nr(0x00);
+        header.client_key(client->get_client_key());
+
+        /* HEARTBEAT subheader. */
+        dds::xrce::SubmessageHeader subheader;
+        subheader.submessage_id(dds::xrce::HEARTBEAT);
+        subheader.flags(dds::xrce::FLAG_LITTLE_ENDIANNESS);
+        subheader.submessage_length(uint16_t(heartbeat.getCdrSerializedSize()));
+
+        const size_t message_size =
+                header.getCdrSerializedSize() +
+                subheader.getCdrSerializedSize() +
+                heartbeat.getCdrSerializedSize();
+
+        output_packet.message = OutputMessagePtr(new OutputMessage(header, message_size));
+        output_packet.message->append_submessage(dds::xrce::HEARTBEAT, heartbeat);
+
+        /* Send message. */
+        server_.push_output_packet(output_packet, CONTROL_OUTPUT_PRIORITY);
+    }
 
-    std::shared_ptr<ProxyClient> client;
-    while (root_.get_next_client(client))
+    schedule_heartbeat(client, stream_id, client->session().get_heartbeat_period(stream_id));
+}
+
+void Processor::arm_flush(
+        ProxyClient& client,
+        uint8_t stream_id)
+{
+    SeqNum seq_num;
+    if (!client.session().arm_flush(stream_id, seq_num))
     {
-        if ((output_packet.destination = server_.get_source(client->get_client_key())))
-        {
-            header.session_id(client->get_session_id());
-            header.client_key(client->get_client_key());
+        return;
+    }
 
-            /* Get reliable streams. */
-            for (auto stream : client->session().get_output_streams())
-            {
-                /* Get and send pending messages. */
-                if (client->session().fill_heartbeat(stream, heartbeat))
-                {
-                    output_packet.message = OutputMessagePtr(new OutputMessage(header, message_size));
-                    output_packet.message->append_submessage(dds::xrce::HEARTBEAT, heartbeat);
+    const utils::TimerWheel::Tick deadline =
+            utils::TimerWheel::to_tick(std::chrono::steady_clock::now()) +
+            utils::TimerWheel::Tick(coalescing_window_.count());
+    std::weak_ptr<ProxyClient> weak_client(root_.get_client(client.get_client_key()));
+    std::lock_guard<std::mutex> lock(timer_mtx_);
+    /* The timer of a message sent before its deadline is still pending, one timer per stream is enough. */
+    timers_.cancel(client.session().get_flush_timer(stream_id));
+    utils::TimerWheel::TimerId timer_id = timers_.schedule(deadline, [this, weak_client, stream_id, seq_num]()
+    {
+        flush_output(weak_client, stream_id, seq_num);
+    });
+    client.session().set_flush_timer(stream_id, timer_id);
+    if (deadline < timer_wakeup_)
+    {
+        timer_cv_.notify_one();
+    }
+}
 
-                    /* Send message. */
-                    server_.push_output_packet(output_packet);
-                }
-            }
+void Processor::flush_output(
+        const std::weak_ptr<ProxyClient>& weak_client,
+        uint8_t stream_id,
+        SeqNum seq_num)
+{
+    /* Deleted clients drop their timers. */
+    std::shared_ptr<ProxyClient> client = weak_client.lock();
+    if (!client)
+    {
+        return;
+    }
+
+    /* A message already sent because it was full leaves nothing to flush, nor does the next one open. */
+    if (!client->session().is_flush_armed(stream_id, seq_num))
+    {
+        return;
+    }
+
+    OutputPacket output_packet;
+    if ((output_packet.destination = client->get_source()))
+    {
+        while (client->session().get_next_output_message(stream_id, output_packet.message))
+        {
+            server_.push_output_packet(output_packet, get_output_priority(stream_id));
         }
     }
 }
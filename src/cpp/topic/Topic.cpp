@@ -66,11 +66,16 @@ Topic::~Topic()
 
 void Topic::release(ObjectContainer& root_objects)
 {
-    while (!tied_objects_.empty())
+    std::set<dds::xrce::ObjectId> tied_objects;
+    tied_objects.swap(tied_objects_);
+    for (const auto& obj : tied_objects)
     {
-        auto obj = tied_objects_.begin();
-        root_objects.at(*obj)->release(root_objects);
-        root_objects.erase(*obj);
+        auto it = root_objects.find(obj);
+        if (it != root_objects.end())
+        {
+            it->second->release(root_objects);
+            root_objects.erase(it);
+        }
     }
 }
 
@@ -13,10 +13,13 @@
 // limitations under the License.
 
 #include <uxr/agent/transport/Server.hpp>
+#include <uxr/agent/transport/InputDispatcher.hpp>
 #include <uxr/agent/config.hpp>
 #include <uxr/agent/processor/Processor.hpp>
 #include <uxr/agent/Root.hpp>
 #include <uxr/agent/logger/Logger.hpp>
+#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+#include <uxr/agent/scheduler/RingScheduler.hpp>
 
 #include <functional>
 
@@ -25,11 +28,37 @@
 namespace eprosima {
 namespace uxr {
 
+template<class T>
+static Scheduler<T>* create_scheduler(
+        SchedulerKind scheduler_kind,
+        size_t max_size)
+{
+    Scheduler<T>* scheduler = nullptr;
+    switch (scheduler_kind)
+    {
+        case SchedulerKind::FCFS:
+            scheduler = new FCFSScheduler<T>(max_size);
+            break;
+        case SchedulerKind::RING:
+            scheduler = new RingScheduler<T>(max_size);
+            break;
+    }
+    return scheduler;
+}
+
 Server::Server(Middleware::Kind middleware_kind)
     : processor_(new Processor(*this, *root_, middleware_kind))
     , running_cond_(false)
-    , input_scheduler_(SERVER_QUEUE_MAX_SIZE)
-    , output_scheduler_(SERVER_QUEUE_MAX_SIZE)
+    , input_received_(0)
+    , recv_batch_size_(1)
+    , send_batch_size_(1)
+    , worker_count_(1)
+    , queue_size_(SERVER_QUEUE_MAX_SIZE)
+    , scheduler_kind_(SchedulerKind::FCFS)
+    , input_overflow_policy_(OverflowPolicy::DROP_OLDEST)
+    , input_block_timeout_(0)
+    , input_schedulers_()
+    , output_scheduler_(SERVER_QUEUE_MAX_SIZE, OUTPUT_PRIORITY_LEVELS)
 {}
 
 Server::~Server()
@@ -47,15 +76,29 @@ bool Server::run()
         return false;
     }
 
-    /* Scheduler initialization. */
-    input_scheduler_.init();
+    /* Scheduler initialization, one input queue per processing worker. */
+    input_schedulers_.clear();
+    for (size_t i = 0; i < worker_count_; ++i)
+    {
+        input_schedulers_.emplace_back(
+            create_scheduler<InputPacket>(scheduler_kind_, queue_size_ / worker_count_));
+        input_schedulers_.back()->set_overflow_policy(input_overflow_policy_, input_block_timeout_);
+        input_schedulers_.back()->init();
+    }
+    output_scheduler_.set_max_size(queue_size_);
     output_scheduler_.init();
 
     /* Thread initialization. */
     running_cond_ = true;
-    receiver_thread_ = std::thread(&Server::receiver_loop, this);
+    for (size_t i = 0; i < get_receiver_count(); ++i)
+    {
+        receiver_threads_.emplace_back(&Server::receiver_loop, this, i);
+    }
     sender_thread_ = std::thread(&Server::sender_loop, this);
-    processing_thread_ = std::thread(&Server::processing_loop, this);
+    for (size_t i = 0; i < worker_count_; ++i)
+    {
+        processing_threads_.emplace_back(&Server::processing_loop, this, i);
+    }
     heartbeat_thread_ = std::thread(&Server::heartbeat_loop, this);
 
     return true;
@@ -67,22 +110,33 @@ bool Server::stop()
     running_cond_ = false;
 
     /* Stop input and output queues. */
-    input_scheduler_.deinit();
+    for (auto& input_scheduler : input_schedulers_)
+    {
+        input_scheduler->deinit();
+    }
     output_scheduler_.deinit();
 
     /* Join threads. */
-    if (receiver_thread_.joinable())
+    for (auto& receiver_thread : receiver_threads_)
     {
-        receiver_thread_.join();
+        if (receiver_thread.joinable())
+        {
+            receiver_thread.join();
+        }
     }
+    receiver_threads_.clear();
     if (sender_thread_.joinable())
     {
         sender_thread_.join();
     }
-    if (processing_thread_.joinable())
+    for (auto& processing_thread : processing_threads_)
     {
-        processing_thread_.join();
+        if (processing_thread.joinable())
+        {
+            processing_thread.join();
+        }
     }
+    processing_threads_.clear();
     if (heartbeat_thread_.joinable())
     {
         heartbeat_thread_.join();
@@ -100,6 +154,131 @@ bool Server::stop()
     return rv;
 }
 
+bool Server::set_recv_batch_size(size_t batch_size)
+{
+    bool rv = false;
+    if (!running_cond_ && (0 < batch_size))
+    {
+        recv_batch_size_ = batch_size;
+        rv = true;
+    }
+    return rv;
+}
+
+bool Server::set_send_batch_size(size_t batch_size)
+{
+    bool rv = false;
+    if (!running_cond_ && (0 < batch_size))
+    {
+        send_batch_size_ = batch_size;
+        rv = true;
+    }
+    return rv;
+}
+
+bool Server::set_worker_count(size_t worker_count)
+{
+    bool rv = false;
+    if (!running_cond_ && (0 < worker_count) && (queue_size_ >= worker_count))
+    {
+        worker_count_ = worker_count;
+        rv = true;
+    }
+    return rv;
+}
+
+bool Server::set_scheduler_kind(SchedulerKind scheduler_kind)
+{
+    bool rv = false;
+    if (!running_cond_)
+    {
+        scheduler_kind_ = scheduler_kind;
+        rv = true;
+    }
+    return rv;
+}
+
+bool Server::set_queue_size(size_t queue_size)
+{
+    bool rv = false;
+    if (!running_cond_ && (worker_count_ <= queue_size))
+    {
+        queue_size_ = queue_size;
+        rv = true;
+    }
+    return rv;
+}
+
+bool Server::set_stream_depths(
+        uint16_t best_effort_depth,
+        uint16_t reliable_depth)
+{
+    bool rv = false;
+    if (!running_cond_)
+    {
+        rv = root_->set_stream_depths(StreamDepths{best_effort_depth, reliable_depth});
+    }
+    return rv;
+}
+
+bool Server::set_input_overflow_policy(
+        OverflowPolicy overflow_policy,
+        std::chrono::milliseconds block_timeout)
+{
+    bool rv = false;
+    if (!running_cond_)
+    {
+        input_overflow_policy_ = overflow_policy;
+        input_block_timeout_ = block_timeout;
+        rv = true;
+    }
+    return rv;
+}
+
+bool Server::set_output_overflow_policy(
+        OverflowPolicy overflow_policy,
+        std::chrono::milliseconds block_timeout)
+{
+    bool rv = false;
+    if (!running_cond_)
+    {
+        output_scheduler_.set_overflow_policy(overflow_policy, block_timeout);
+        rv = true;
+    }
+    return rv;
+}
+
+bool Server::set_coalescing_window(std::chrono::milliseconds window)
+{
+    bool rv = false;
+    if (!running_cond_ && (std::chrono::milliseconds(0) <= window))
+    {
+        processor_->set_coalescing_window(window);
+        rv = true;
+    }
+    return rv;
+}
+
+uint64_t Server::get_input_received() const
+{
+    return input_received_.load(std::memory_order_relaxed);
+}
+
+uint64_t Server::get_input_dropped() const
+{
+    uint64_t dropped = 0;
+    for (const auto& input_scheduler : input_schedulers_)
+    {
+        dropped += input_scheduler->get_dropped();
+    }
+    return dropped;
+}
+
+uint64_t Server::get_output_dropped() const
+{
+    return output_scheduler_.get_dropped();
+}
+
 #ifdef UAGENT_DISCOVERY_PROFILE
 bool Server::enable_discovery(uint16_t discovery_port)
 {
@@ -134,44 +313,116 @@ bool Server::disable_p2p()
 }
 #endif
 
-void Server::push_output_packet(OutputPacket output_packet)
+void Server::push_output_packet(
+        OutputPacket output_packet,
+        OutputPriority priority)
 {
     if (output_packet.destination && output_packet.message)
     {
-        output_scheduler_.push(std::move(output_packet), 0);
+        output_scheduler_.push(std::move(output_packet), priority);
     }
 }
 
-void Server::receiver_loop()
+size_t Server::get_receiver_count() const
+{
+    return 1;
+}
+
+bool Server::recv_messages(
+        std::vector<InputPacket>& input_packets,
+        size_t max_packets,
+        int timeout,
+        size_t receiver_id)
 {
+    (void) max_packets;
+    (void) receiver_id;
     InputPacket input_packet;
-    while (running_cond_)
+    bool rv = recv_message(input_packet, timeout);
+    if (rv)
+    {
+        input_packets.push_back(std::move(input_packet));
+    }
+    return rv;
+}
+
+void Server::receiver_loop(size_t receiver_id)
+{
+    if ((1 == recv_batch_size_) && (1 == get_receiver_count()))
+    {
+        InputDispatcher input_dispatcher(input_schedulers_);
+        InputPacket input_packet;
+        while (running_cond_)
+        {
+            if (recv_message(input_packet, RECEIVE_TIMEOUT))
+            {
+                input_received_.fetch_add(1, std::memory_order_relaxed);
+                input_dispatcher.push(std::move(input_packet));
+            }
+        }
+    }
+    else
     {
-        if (recv_message(input_packet, RECEIVE_TIMEOUT))
+        /* Batched reception, the whole batch is queued at once. */
+        InputDispatcher input_dispatcher(input_schedulers_);
+        std::vector<InputPacket> input_packets;
+        input_packets.reserve(recv_batch_size_);
+        while (running_cond_)
         {
-            input_scheduler_.push(std::move(input_packet), 0);
+            if (recv_messages(input_packets, recv_batch_size_, RECEIVE_TIMEOUT, receiver_id))
+            {
+                input_received_.fetch_add(input_packets.size(), std::memory_order_relaxed);
+                input_dispatcher.push_batch(input_packets);
+            }
         }
     }
 }
 
+bool Server::send_messages(std::vector<OutputPacket>& output_packets)
+{
+    bool rv = true;
+    for (auto& output_packet : output_packets)
+    {
+        rv &= send_message(std::move(output_packet));
+    }
+    output_packets.clear();
+    return rv;
+}
+
 void Server::sender_loop()
 {
-    OutputPacket output_packet;
-    while (running_cond_)
+    if (1 == send_batch_size_)
     {
-        if (output_scheduler_.pop(output_packet))
+        OutputPacket output_packet;
+        while (running_cond_)
         {
-            send_message(output_packet);
+            if (output_scheduler_.pop(output_packet))
+            {
+                send_message(output_packet);
+            }
+        }
+    }
+    else
+    {
+        /* Batched sending, everything queued is flushed at once up to the batch size. */
+        std::vector<OutputPacket> output_packets;
+        output_packets.reserve(send_batch_size_);
+        while (running_cond_)
+        {
+            if (output_scheduler_.pop_batch(output_packets, send_batch_size_))
+            {
+                send_messages(output_packets);
+            }
         }
     }
 }
 
-void Server::processing_loop()
+void Server::processing_loop(size_t worker_id)
 {
+    Scheduler<InputPacket>& input_scheduler = *input_schedulers_[worker_id];
     InputPacket input_packet;
     while (running_cond_)
     {
-        if (input_scheduler_.pop(input_packet))
+        if (input_scheduler.pop(input_packet))
         {
             processor_->process_input_packet(std::move(input_packet));
         }
@@ -180,10 +431,25 @@ void Server::processing_loop()
 
 void Server::heartbeat_loop()
 {
+    const std::chrono::milliseconds heartbeat_period(HEARTBEAT_PERIOD);
+    uint64_t input_dropped = get_input_dropped();
+    uint64_t output_dropped = get_output_dropped();
     while (running_cond_)
     {
-        processor_->check_heartbeats();
-        std::this_thread::sleep_for(std::chrono::milliseconds(HEARTBEAT_PERIOD));
+        /* Only streams with unacknowledged messages have a heartbeat due, and with coalesced ones a flush. */
+        processor_->check_timers(heartbeat_period);
+
+        /* Report queue overflows. */
+        if ((input_dropped != get_input_dropped()) || (output_dropped != get_output_dropped()))
+        {
+            input_dropped = get_input_dropped();
+            output_dropped = get_output_dropped();
+            UXR_AGENT_LOG_WARN(
+                UXR_DECORATE_YELLOW("queue overflow"),
+                "input dropped: {}, output dropped: {}",
+                input_dropped,
+                output_dropped);
+        }
     }
 }
 
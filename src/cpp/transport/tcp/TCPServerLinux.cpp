@@ -18,10 +18,12 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <arpa/inet.h>
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <signal.h>
 #include <functional>
 
@@ -29,19 +31,17 @@ namespace eprosima {
 namespace uxr {
 
 const uint8_t max_attemps = 16;
+const int max_events = 64;
+const uint64_t listener_id = UINT64_MAX;
 
 TCPv4Agent::TCPv4Agent(
         uint16_t agent_port,
         Middleware::Kind middleware_kind)
     : TCPServerBase{agent_port, middleware_kind}
     , connections_{}
-    , active_connections_{}
-    , free_connections_{}
-    , listener_poll_{}
-    , poll_fds_{}
-    , buffer_{0}
-    , listener_thread_{}
-    , running_cond_{false}
+    , next_connection_id_{0}
+    , listener_fd_{-1}
+    , epoll_fd_{-1}
     , messages_queue_{}
 #ifdef UAGENT_DISCOVERY_PROFILE
     , discovery_server_{*processor_}
@@ -73,10 +73,11 @@ bool TCPv4Agent::init()
     /* Ignore SIGPIPE signal. */
     signal(SIGPIPE, sigpipe_handler);
 
-    /* Listener socket initialization. */
-    listener_poll_.fd = socket(PF_INET, SOCK_STREAM, 0);
+    /* Event loop and listener socket initialization. */
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    listener_fd_ = socket(PF_INET, SOCK_STREAM, 0);
 
-    if (-1 != listener_poll_.fd)
+    if ((-1 != epoll_fd_) && (-1 != listener_fd_))
     {
         /* IP and Port setup. */
         struct sockaddr_in address;
@@ -84,7 +85,7 @@ bool TCPv4Agent::init()
         address.sin_port = htons(transport_address_.medium_locator().port());
         address.sin_addr.s_addr = INADDR_ANY;
         memset(address.sin_zero, '\0', sizeof(address.sin_zero));
-        if (-1 != bind(listener_poll_.fd, (struct sockaddr*)&address, sizeof(address)))
+        if (-1 != bind(listener_fd_, (struct sockaddr*)&address, sizeof(address)))
         {
             /* Log. */
             UXR_AGENT_LOG_DEBUG(
@@ -92,27 +93,14 @@ bool TCPv4Agent::init()
                 "port: {}",
                 transport_address_.medium_locator().port());
 
-            /* Setup listener poll. */
-            listener_poll_.events = POLLIN;
-
-            /* Setup connections. */
-            for (size_t i = 0; i < poll_fds_.size(); ++i)
+            /* Init listener, accepting is driven by the event loop. */
+            struct epoll_event event;
+            event.events = EPOLLIN | EPOLLET;
+            event.data.u64 = listener_id;
+            if ((-1 != fcntl(listener_fd_, F_SETFL, fcntl(listener_fd_, F_GETFL, 0) | O_NONBLOCK)) &&
+                (-1 != listen(listener_fd_, TCP_MAX_BACKLOG_CONNECTIONS)) &&
+                (-1 != epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listener_fd_, &event)))
             {
-                poll_fds_[i].fd = -1;
-                poll_fds_[i].events = POLLIN;
-                connections_[i].poll_fd = &poll_fds_[i];
-                connections_[i].id = uint32_t(i);
-                connections_[i].active = false;
-                init_input_buffer(connections_[i].input_buffer);
-                free_connections_.push_back(connections_[i].id);
-            }
-
-            /* Init listener. */
-            if (-1 != listen(listener_poll_.fd, TCP_MAX_BACKLOG_CONNECTIONS))
-            {
-                running_cond_ = true;
-                listener_thread_ = std::thread(&TCPv4Agent::listener_loop, this);
-
                 /* Get local address. */
                 int fd = socket(PF_INET, SOCK_DGRAM, 0);
                 struct sockaddr_in temp_addr;
@@ -167,37 +155,48 @@ bool TCPv4Agent::init()
 
 bool TCPv4Agent::close()
 {
-    /* Stop listener thread. */
-    running_cond_ = false;
-    if (listener_thread_.joinable())
+    /* Close listener. */
+    if (-1 != listener_fd_)
     {
-        listener_thread_.join();
+        if (0 == ::close(listener_fd_))
+        {
+            listener_fd_ = -1;
+        }
     }
 
-    /* Close listener. */
-    if (-1 != listener_poll_.fd)
+    /* Disconnect clients. */
+    std::vector<std::shared_ptr<TCPConnectionPlatform>> connections;
     {
-        if (0 == ::close(listener_poll_.fd))
+        std::lock_guard<std::mutex> lock(connections_mtx_);
+        for (auto& entry : connections_)
         {
-            listener_poll_.fd = -1;
+            connections.push_back(entry.second);
         }
     }
+    for (auto& conn : connections)
+    {
+        close_connection(*conn);
+    }
 
-    /* Disconnect clients. */
-    for (auto& conn : connections_)
+    /* Close event loop. */
+    if (-1 != epoll_fd_)
     {
-        close_connection(conn);
+        if (0 == ::close(epoll_fd_))
+        {
+            epoll_fd_ = -1;
+        }
     }
 
     std::lock_guard<std::mutex> lock(connections_mtx_);
 
     bool rv = false;
-    if ((-1 == listener_poll_.fd) && (active_connections_.empty()))
+    if ((-1 == listener_fd_) && (-1 == epoll_fd_) && (connections_.empty()))
     {
         UXR_AGENT_LOG_INFO(
             UXR_DECORATE_GREEN("server stopped"),
             "port: {}",
             transport_address_.medium_locator().port());
+        rv = true;
     }
     else
     {
@@ -261,6 +260,31 @@ bool TCPv4Agent::recv_message(
     return rv;
 }
 
+bool TCPv4Agent::recv_messages(
+        std::vector<InputPacket>& input_packets,
+        size_t max_packets,
+        int timeout,
+        size_t receiver_id)
+{
+    (void) receiver_id;
+    if (messages_queue_.empty())
+    {
+        read_message(timeout);
+    }
+
+    while (!messages_queue_.empty() && (input_packets.size() < max_packets))
+    {
+        UXR_AGENT_LOG_MESSAGE(
+            UXR_DECORATE_YELLOW("[==>> TCP <<==]"),
+            conversion::clientkey_to_raw(get_client_key(messages_queue_.front().source.get())),
+            messages_queue_.front().message->get_buf(),
+            messages_queue_.front().message->get_len());
+        input_packets.push_back(std::move(messages_queue_.front()));
+        messages_queue_.pop();
+    }
+    return !input_packets.empty();
+}
+
 bool TCPv4Agent::send_message(OutputPacket output_packet)
 {
     bool rv = false;
@@ -272,7 +296,8 @@ bool TCPv4Agent::send_message(OutputPacket output_packet)
     auto it = source_to_connection_map_.find(source_id);
     if (it != source_to_connection_map_.end())
     {
-        TCPConnection& connection = connections_.at(it->second);
+        std::shared_ptr<TCPConnectionPlatform> connection_ptr = connections_.at(it->second);
+        TCPConnection& connection = *connection_ptr;
         lock.unlock();
 
         msg_size_buf[0] = uint8_t(0x00FF & output_packet.message->get_len());
@@ -360,23 +385,44 @@ bool TCPv4Agent::open_connection(
         struct sockaddr_in* sockaddr)
 {
     bool rv = false;
+    std::shared_ptr<TCPConnectionPlatform> connection = std::make_shared<TCPConnectionPlatform>();
+    connection->fd = fd;
+    connection->addr = sockaddr->sin_addr.s_addr;
+    connection->port = sockaddr->sin_port;
+    connection->endpoint = std::make_shared<IPv4EndPoint>(connection->addr, connection->port);
+    connection->active = true;
+    init_input_buffer(connection->input_buffer);
+
     std::lock_guard<std::mutex> lock(connections_mtx_);
-    if (!free_connections_.empty())
-    {
-        uint32_t id = free_connections_.front();
-        TCPConnectionPlatform& connection = connections_[size_t(id)];
-        connection.poll_fd->fd = fd;
-        connection.addr = sockaddr->sin_addr.s_addr;
-        connection.port = sockaddr->sin_port;
-        connection.active = true;
-        init_input_buffer(connection.input_buffer);
+    connection->id = next_connection_id_++;
 
-        uint64_t source_id = (uint64_t(connection.addr) << 16) | connection.port;
-        source_to_connection_map_[source_id] = connection.id;
-        active_connections_.insert(id);
-        free_connections_.pop_front();
+    /* Events carry the connection id, so a stale event never reaches a reused descriptor. */
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    event.data.u64 = connection->id;
+    if (-1 != epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event))
+    {
+        uint64_t source_id = (uint64_t(connection->addr) << 16) | connection->port;
+        source_to_connection_map_[source_id] = connection->id;
+        connections_.emplace(connection->id, std::move(connection));
         rv = true;
     }
+    else
+    {
+        ::close(fd);
+    }
+    return rv;
+}
+
+std::shared_ptr<TCPConnectionPlatform> TCPv4Agent::get_connection(uint32_t connection_id)
+{
+    std::shared_ptr<TCPConnectionPlatform> rv;
+    std::lock_guard<std::mutex> lock(connections_mtx_);
+    auto it = connections_.find(connection_id);
+    if (it != connections_.end())
+    {
+        rv = it->second;
+    }
     return rv;
 }
 
@@ -385,36 +431,38 @@ bool TCPv4Agent::close_connection(TCPConnection& connection)
     bool rv = false;
     TCPConnectionPlatform& connection_platform = static_cast<TCPConnectionPlatform&>(connection);
     std::unique_lock<std::mutex> lock(connections_mtx_);
-    auto it_conn = active_connections_.find(connection.id);
-    if (it_conn != active_connections_.end())
+    auto it_conn = connections_.find(connection.id);
+    if (it_conn != connections_.end())
     {
+        /* Keep the connection alive until it is closed. */
+        std::shared_ptr<TCPConnectionPlatform> connection_ptr = std::move(it_conn->second);
+        uint64_t source_id = (uint64_t(connection.addr) << 16) | connection.port;
+
+        /* Clear connections map. */
+        connections_.erase(it_conn);
+        auto it_source = source_to_connection_map_.find(source_id);
+        if ((it_source != source_to_connection_map_.end()) && (it_source->second == connection.id))
+        {
+            source_to_connection_map_.erase(it_source);
+        }
         lock.unlock();
+
         /* Add lock for close. */
         std::unique_lock<std::mutex> conn_lock(connection.mtx);
-        if (0 == ::close(connection_platform.poll_fd->fd))
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, connection_platform.fd, nullptr);
+        ::close(connection_platform.fd);
+        connection_platform.fd = -1;
+        connection.active = false;
+        conn_lock.unlock();
+
+        std::unique_lock<std::mutex> client_lock(clients_mtx_);
+        auto it_client = source_to_client_map_.find(source_id);
+        if (it_client != source_to_client_map_.end())
         {
-            connection_platform.poll_fd->fd = -1;
-            connection.active = false;
-            conn_lock.unlock();
-
-            uint64_t source_id = (uint64_t(connection.addr) << 16) | connection.port;
-
-            /* Clear connections map and lists. */
-            lock.lock();
-            source_to_connection_map_.erase(source_id);
-            active_connections_.erase(it_conn);
-            free_connections_.push_back(connection.id);
-            lock.unlock();
-
-            std::unique_lock<std::mutex> client_lock(clients_mtx_);
-            auto it_client = source_to_client_map_.find(source_id);
-            if (it_client != source_to_client_map_.end())
-            {
-                client_to_source_map_.erase(it_client->second);
-                source_to_client_map_.erase(it_client->first);
-            }
-            rv = true;
+            client_to_source_map_.erase(it_client->second);
+            source_to_client_map_.erase(it_client->first);
         }
+        rv = true;
     }
     return rv;
 }
@@ -427,66 +475,74 @@ void TCPv4Agent::init_input_buffer(TCPInputBuffer& buffer)
 
 bool TCPv4Agent::read_message(int timeout)
 {
-    bool rv = false;
-    int poll_rv = poll(poll_fds_.data(), poll_fds_.size(), timeout);
-    if (0 < poll_rv)
+    struct epoll_event events[max_events];
+    int epoll_rv = epoll_wait(epoll_fd_, events, max_events, timeout);
+    if (0 < epoll_rv)
     {
-        for (auto& conn : connections_)
+        for (int i = 0; i < epoll_rv; ++i)
         {
-            if (POLLIN == (POLLIN & conn.poll_fd->revents))
+            if (listener_id == events[i].data.u64)
             {
-                uint16_t bytes_read = read_data(conn);
-                if (0 < bytes_read)
-                {
-                    InputPacket input_packet;
-                    input_packet.message.reset(new InputMessage(conn.input_buffer.buffer.data(), bytes_read));
-                    input_packet.source.reset(new IPv4EndPoint(conn.addr, conn.port));
-                    messages_queue_.push(std::move(input_packet));
-                    rv = true;
-                }
+                accept_connections();
+            }
+            else
+            {
+                read_connection(uint32_t(events[i].data.u64));
             }
         }
     }
     else
     {
-        if (0 == poll_rv)
+        if (0 == epoll_rv)
         {
             errno = ETIME;
         }
     }
-    return rv;
+    return !messages_queue_.empty();
 }
 
-void TCPv4Agent::listener_loop()
+void TCPv4Agent::accept_connections()
 {
-    while (running_cond_)
+    /* Edge-triggered, so drain the backlog. */
+    while (true)
     {
-        int poll_rv = poll(&listener_poll_, 1, 100);
-        if (0 < poll_rv)
+        struct sockaddr client_addr;
+        socklen_t client_addr_len = sizeof(client_addr);
+        int incoming_fd = accept(listener_fd_, &client_addr, &client_addr_len);
+        if (-1 != incoming_fd)
         {
-            if (POLLIN == (POLLIN & listener_poll_.revents))
+            open_connection(incoming_fd, (struct sockaddr_in*)&client_addr);
+        }
+        else if (EINTR != errno)
+        {
+            if ((EAGAIN != errno) && (EWOULDBLOCK != errno))
             {
-                if (connection_available())
-                {
-                    /* New client connection. */
-                    struct sockaddr client_addr;
-                    socklen_t client_addr_len = sizeof(client_addr);
-                    int incoming_fd = accept(listener_poll_.fd, &client_addr, &client_addr_len);
-                    if (-1 != incoming_fd)
-                    {
-                        /* Open connection. */
-                        open_connection(incoming_fd, (struct sockaddr_in*)&client_addr);
-                    }
-                }
+                UXR_AGENT_LOG_WARN(
+                    UXR_DECORATE_YELLOW("accept error"),
+                    "port: {}, errno: {}",
+                    transport_address_.medium_locator().port(),
+                    errno);
             }
+            break;
         }
     }
 }
 
-bool TCPv4Agent::connection_available()
+void TCPv4Agent::read_connection(uint32_t connection_id)
 {
-    std::lock_guard<std::mutex> lock(connections_mtx_);
-    return !free_connections_.empty();
+    std::shared_ptr<TCPConnectionPlatform> connection = get_connection(connection_id);
+    if (connection)
+    {
+        /* Edge-triggered, so read until the socket is drained or closed. */
+        uint16_t bytes_read;
+        while (0 < (bytes_read = read_data(*connection)))
+        {
+            InputPacket input_packet;
+            input_packet.message.reset(new InputMessage(connection->input_buffer.buffer.data(), bytes_read));
+            input_packet.source = connection->endpoint;
+            messages_queue_.push(std::move(input_packet));
+        }
+    }
 }
 
 size_t TCPv4Agent::recv_locking(
@@ -498,25 +554,24 @@ size_t TCPv4Agent::recv_locking(
     size_t rv = 0;
     TCPConnectionPlatform& connection_platform = static_cast<TCPConnectionPlatform&>(connection);
     std::lock_guard<std::mutex> lock(connection.mtx);
+    errcode = 0;
     if (connection.active)
     {
-        int poll_rv = poll(connection_platform.poll_fd, 1, 0);
-        if (0 < poll_rv)
+        ssize_t bytes_received;
+        do
         {
-            ssize_t bytes_received = recv(connection_platform.poll_fd->fd, (void*)buffer, len, 0);
-            if (0 < bytes_received)
-            {
-                rv = size_t(bytes_received);
-                errcode = 0;
-            }
-            else
-            {
-                errcode = 1;
-            }
+            bytes_received = recv(connection_platform.fd, (void*)buffer, len, MSG_DONTWAIT);
         }
-        else
+        while ((-1 == bytes_received) && (EINTR == errno));
+
+        if (0 < bytes_received)
+        {
+            rv = size_t(bytes_received);
+        }
+        else if ((0 == bytes_received) || ((EAGAIN != errno) && (EWOULDBLOCK != errno)))
         {
-            errcode = (0 == poll_rv) ? 0 : 1;
+            /* Peer closed or socket error. */
+            errcode = 1;
         }
     }
     return rv;
@@ -533,7 +588,7 @@ size_t TCPv4Agent::send_locking(
     std::lock_guard<std::mutex> lock(connection.mtx);
     if (connection.active)
     {
-        ssize_t bytes_sent = send(connection_platform.poll_fd->fd, (void*)buffer, len, 0);
+        ssize_t bytes_sent = send(connection_platform.fd, (void*)buffer, len, 0);
         if (-1 != bytes_sent)
         {
             rv = size_t(bytes_sent);
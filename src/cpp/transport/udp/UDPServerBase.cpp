@@ -46,12 +46,13 @@ void UDPServerBase::on_create_client(
     auto it_client = client_to_source_map_.find(client_id);
     if (it_client != client_to_source_map_.end())
     {
-        source_to_client_map_.erase(it_client->second);
-        it_client->second = source_id;
+        const IPv4EndPoint& previous = it_client->second;
+        source_to_client_map_.erase((uint64_t(previous.get_addr()) << 16) | previous.get_port());
+        it_client->second = *endpoint;
     }
     else
     {
-        client_to_source_map_.insert(std::make_pair(client_id, source_id));
+        client_to_source_map_.insert(std::make_pair(client_id, *endpoint));
         UXR_AGENT_LOG_INFO(
             UXR_DECORATE_GREEN("session established"),
             "client_key: 0x{:08X}, address: {}",
@@ -124,8 +125,7 @@ std::unique_ptr<EndPoint> UDPServerBase::get_source(const dds::xrce::ClientKey&
     auto it = client_to_source_map_.find(client_id);
     if (it != client_to_source_map_.end())
     {
-        uint64_t source_id = it->second;
-        source.reset(new IPv4EndPoint(uint32_t(source_id >> 16), uint16_t(source_id & 0xFFFF)));
+        source.reset(new IPv4EndPoint(it->second));
     }
     return source;
 }
@@ -24,6 +24,8 @@
 #include <string.h>
 #include <errno.h>
 
+#define ENDPOINT_CACHE_MAX_SIZE 4096
+
 namespace eprosima {
 namespace uxr {
 
@@ -31,9 +33,13 @@ UDPv4Agent::UDPv4Agent(
         uint16_t agent_port,
         Middleware::Kind middleware_kind)
     : UDPServerBase{agent_port, middleware_kind}
-    , poll_fd_{-1, 0, 0}
+    , socket_count_{1}
+    , sockets_{}
     , buffer_{0}
     , port_{agent_port}
+    , send_headers_{}
+    , send_iovecs_{}
+    , send_addrs_{}
 #ifdef UAGENT_DISCOVERY_PROFILE
     , discovery_server_{*processor_}
 #endif
@@ -57,14 +63,77 @@ UDPv4Agent::~UDPv4Agent()
     }
 }
 
+bool UDPv4Agent::set_socket_count(size_t socket_count)
+{
+    bool rv = false;
+    if (sockets_.empty() && (0 < socket_count) && (UINT16_MAX >= socket_count))
+    {
+        socket_count_ = socket_count;
+        rv = true;
+    }
+    return rv;
+}
+
 bool UDPv4Agent::init()
+{
+    bool rv = true;
+
+    /* Sockets initialization, the kernel spreads the flows among them by 4-tuple hash. */
+    for (size_t i = 0; rv && (i < socket_count_); ++i)
+    {
+        std::unique_ptr<Socket> socket(new Socket{});
+        socket->id = uint16_t(i);
+        socket->poll_fd.fd = -1;
+        rv = open_socket(*socket);
+        sockets_.push_back(std::move(socket));
+    }
+
+    if (rv)
+    {
+        /* Get local address. */
+        rv = false;
+        int fd = socket(PF_INET, SOCK_DGRAM, 0);
+        struct sockaddr_in temp_addr;
+        temp_addr.sin_family = AF_INET;
+        temp_addr.sin_port = htons(80);
+        temp_addr.sin_addr.s_addr = inet_addr("1.2.3.4");
+        int connected = connect(fd, (struct sockaddr *)&temp_addr, sizeof(temp_addr));
+        if (0 == connected)
+        {
+            struct sockaddr local_addr;
+            socklen_t local_addr_len = sizeof(local_addr);
+            if (-1 != getsockname(fd, &local_addr, &local_addr_len))
+            {
+                transport_address_.medium_locator().address({uint8_t(local_addr.sa_data[2]),
+                                                             uint8_t(local_addr.sa_data[3]),
+                                                             uint8_t(local_addr.sa_data[4]),
+                                                             uint8_t(local_addr.sa_data[5])});
+                rv = true;
+                UXR_AGENT_LOG_INFO(
+                    UXR_DECORATE_GREEN("running..."),
+                    "port: {}",
+                    transport_address_.medium_locator().port());
+            }
+            ::close(fd);
+        }
+    }
+
+    if (!rv)
+    {
+        close();
+    }
+
+    return rv;
+}
+
+bool UDPv4Agent::open_socket(Socket& socket)
 {
     bool rv = false;
 
     /* Socker initialization. */
-    poll_fd_.fd = socket(PF_INET, SOCK_DGRAM, 0);
+    socket.poll_fd.fd = ::socket(PF_INET, SOCK_DGRAM, 0);
 
-    if (-1 != poll_fd_.fd)
+    if (-1 != socket.poll_fd.fd)
     {
         /* IP and Port setup. */
         struct sockaddr_in address;
@@ -72,43 +141,29 @@ bool UDPv4Agent::init()
         address.sin_port = htons(transport_address_.medium_locator().port());
         address.sin_addr.s_addr = INADDR_ANY;
         memset(address.sin_zero, '\0', sizeof(address.sin_zero));
-        if (-1 != bind(poll_fd_.fd, (struct sockaddr*)&address, sizeof(address)))
+
+        /* Port sharing among the agent sockets. */
+        int reuse_port = 1;
+        if ((1 < socket_count_)
+            && (-1 == setsockopt(socket.poll_fd.fd, SOL_SOCKET, SO_REUSEPORT, &reuse_port, sizeof(reuse_port))))
+        {
+            UXR_AGENT_LOG_ERROR(
+                UXR_DECORATE_RED("reuseport error"),
+                "port: {}",
+                transport_address_.medium_locator().port());
+        }
+        else if (-1 != bind(socket.poll_fd.fd, (struct sockaddr*)&address, sizeof(address)))
         {
             /* Log. */
             UXR_AGENT_LOG_DEBUG(
                 UXR_DECORATE_GREEN("port opened"),
-                "port: {}",
-                transport_address_.medium_locator().port()
-                );
+                "port: {}, socket: {}",
+                transport_address_.medium_locator().port(),
+                socket.id);
 
             /* Poll setup. */
-            poll_fd_.events = POLLIN;
-
-            /* Get local address. */
-            int fd = socket(PF_INET, SOCK_DGRAM, 0);
-            struct sockaddr_in temp_addr;
-            temp_addr.sin_family = AF_INET;
-            temp_addr.sin_port = htons(80);
-            temp_addr.sin_addr.s_addr = inet_addr("1.2.3.4");
-            int connected = connect(fd, (struct sockaddr *)&temp_addr, sizeof(temp_addr));
-            if (0 == connected)
-            {
-                struct sockaddr local_addr;
-                socklen_t local_addr_len = sizeof(local_addr);
-                if (-1 != getsockname(fd, &local_addr, &local_addr_len))
-                {
-                    transport_address_.medium_locator().address({uint8_t(local_addr.sa_data[2]),
-                                                                 uint8_t(local_addr.sa_data[3]),
-                                                                 uint8_t(local_addr.sa_data[4]),
-                                                                 uint8_t(local_addr.sa_data[5])});
-                    rv = true;
-                    UXR_AGENT_LOG_INFO(
-                        UXR_DECORATE_GREEN("running..."),
-                        "port: {}",
-                        transport_address_.medium_locator().port());
-                }
-                ::close(fd);
-            }
+            socket.poll_fd.events = POLLIN;
+            rv = true;
         }
         else
         {
@@ -131,20 +186,27 @@ bool UDPv4Agent::init()
 
 bool UDPv4Agent::close()
 {
-    if (-1 == poll_fd_.fd)
+    if (sockets_.empty())
     {
         return true;
     }
 
-    bool rv = false;
-    if (0 == ::close(poll_fd_.fd))
+    bool rv = true;
+    for (auto& socket : sockets_)
+    {
+        if ((-1 != socket->poll_fd.fd) && (0 != ::close(socket->poll_fd.fd)))
+        {
+            rv = false;
+        }
+    }
+    sockets_.clear();
+
+    if (rv)
     {
         UXR_AGENT_LOG_INFO(
             UXR_DECORATE_GREEN("server stopped"),
             "port: {}",
             transport_address_.medium_locator().port());
-        poll_fd_.fd = -1;
-        rv = true;
     }
     else
     {
@@ -189,19 +251,39 @@ bool UDPv4Agent::close_p2p()
 bool UDPv4Agent::recv_message(InputPacket& input_packet, int timeout)
 {
     bool rv = false;
-    struct sockaddr client_addr;
-    socklen_t client_addr_len = sizeof(client_addr);
+    Socket& socket = *sockets_.front();
 
-    int poll_rv = poll(&poll_fd_, 1, timeout);
+    int poll_rv = poll(&socket.poll_fd, 1, timeout);
     if (0 < poll_rv)
     {
-        ssize_t bytes_received = recvfrom(poll_fd_.fd, buffer_, sizeof(buffer_), 0, &client_addr, &client_addr_len);
-        if (-1 != bytes_received)
+        /* The datagram lands in a pooled slab, the scratch buffer only catches oversized ones. */
+        PooledBuffer slab = InputMessage::acquire_buffer();
+        struct iovec iovecs[2];
+        iovecs[0].iov_base = slab.get();
+        iovecs[0].iov_len = slab.size();
+        iovecs[1].iov_base = buffer_;
+        iovecs[1].iov_len = sizeof(buffer_) - slab.size();
+
+        struct sockaddr_in client_addr;
+        struct msghdr header;
+        memset(&header, 0, sizeof(header));
+        header.msg_name = &client_addr;
+        header.msg_namelen = sizeof(client_addr);
+        header.msg_iov = iovecs;
+        header.msg_iovlen = 2;
+
+        ssize_t bytes_received = recvmsg(socket.poll_fd.fd, &header, 0);
+        if ((-1 != bytes_received) && (0 != (header.msg_flags & MSG_TRUNC)))
+        {
+            UXR_AGENT_LOG_WARN(
+                UXR_DECORATE_YELLOW("truncated datagram dropped"),
+                "port: {}, size: {}",
+                transport_address_.medium_locator().port(),
+                bytes_received);
+        }
+        else if (-1 != bytes_received)
         {
-            input_packet.message.reset(new InputMessage(buffer_, static_cast<size_t>(bytes_received)));
-            uint32_t addr = ((struct sockaddr_in*)&client_addr)->sin_addr.s_addr;
-            uint16_t port = ((struct sockaddr_in*)&client_addr)->sin_port;
-            input_packet.source.reset(new IPv4EndPoint(addr, port));
+            fill_input_packet(socket, input_packet, std::move(slab), buffer_, size_t(bytes_received), client_addr);
             UXR_AGENT_LOG_MESSAGE(
                 UXR_DECORATE_YELLOW("[==>> UDP <<==]"),
                 conversion::clientkey_to_raw(get_client_key(input_packet.source.get())),
@@ -221,6 +303,146 @@ bool UDPv4Agent::recv_message(InputPacket& input_packet, int timeout)
     return rv;
 }
 
+bool UDPv4Agent::recv_messages(
+        std::vector<InputPacket>& input_packets,
+        size_t max_packets,
+        int timeout,
+        size_t receiver_id)
+{
+    bool rv = false;
+    Socket& socket = *sockets_[receiver_id];
+
+    /*
+     * Batch setup, each slot scatters into a pooled slab followed by its own overflow area, so that every
+     * datagram the single-datagram path accepts fits. The overflow areas are left uninitialized, their pages
+     * are only backed once an oversized datagram spills into them.
+     */
+    if (socket.mmsg_headers.size() != max_packets)
+    {
+        socket.mmsg_headers.resize(max_packets);
+        socket.mmsg_iovecs.resize(2 * max_packets);
+        socket.mmsg_addrs.resize(max_packets);
+        socket.mmsg_slabs.resize(max_packets);
+        socket.mmsg_overflows.reset(new uint8_t[max_packets * UINT16_MAX]);
+        for (size_t i = 0; i < max_packets; ++i)
+        {
+            memset(&socket.mmsg_headers[i], 0, sizeof(struct mmsghdr));
+            socket.mmsg_headers[i].msg_hdr.msg_iov = &socket.mmsg_iovecs[2 * i];
+            socket.mmsg_headers[i].msg_hdr.msg_iovlen = 2;
+            socket.mmsg_headers[i].msg_hdr.msg_name = &socket.mmsg_addrs[i];
+        }
+    }
+
+    int poll_rv = poll(&socket.poll_fd, 1, timeout);
+    if (0 < poll_rv)
+    {
+        /* Refill the slabs handed over in the previous batch. */
+        for (size_t i = 0; i < max_packets; ++i)
+        {
+            if (nullptr == socket.mmsg_slabs[i].get())
+            {
+                socket.mmsg_slabs[i] = InputMessage::acquire_buffer();
+            }
+            socket.mmsg_iovecs[2 * i].iov_base = socket.mmsg_slabs[i].get();
+            socket.mmsg_iovecs[2 * i].iov_len = socket.mmsg_slabs[i].size();
+            socket.mmsg_iovecs[2 * i + 1].iov_base = socket.mmsg_overflows.get() + i * UINT16_MAX;
+            socket.mmsg_iovecs[2 * i + 1].iov_len = UINT16_MAX - socket.mmsg_slabs[i].size();
+            socket.mmsg_headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        }
+
+        int messages_received = recvmmsg(socket.poll_fd.fd, socket.mmsg_headers.data(), unsigned(max_packets), MSG_DONTWAIT, nullptr);
+
+        for (int i = 0; i < messages_received; ++i)
+        {
+            const size_t index = size_t(i);
+            const struct mmsghdr& header = socket.mmsg_headers[index];
+            if (0 != (header.msg_hdr.msg_flags & MSG_TRUNC))
+            {
+                UXR_AGENT_LOG_WARN(
+                    UXR_DECORATE_YELLOW("truncated datagram dropped"),
+                    "port: {}, size: {}",
+                    transport_address_.medium_locator().port(),
+                    header.msg_len);
+                continue;
+            }
+
+            InputPacket input_packet;
+            fill_input_packet(socket,
+                              input_packet,
+                              std::move(socket.mmsg_slabs[index]),
+                              socket.mmsg_overflows.get() + index * UINT16_MAX,
+                              size_t(header.msg_len),
+                              socket.mmsg_addrs[index]);
+            UXR_AGENT_LOG_MESSAGE(
+                UXR_DECORATE_YELLOW("[==>> UDP <<==]"),
+                conversion::clientkey_to_raw(get_client_key(input_packet.source.get())),
+                input_packet.message->get_buf(),
+                input_packet.message->get_len());
+            input_packets.push_back(std::move(input_packet));
+        }
+        rv = !input_packets.empty();
+    }
+    else
+    {
+        if (0 == poll_rv)
+        {
+            errno = ETIME;
+        }
+    }
+
+    return rv;
+}
+
+size_t UDPv4Agent::get_receiver_count() const
+{
+    return sockets_.size();
+}
+
+void UDPv4Agent::fill_input_packet(
+        Socket& socket,
+        InputPacket& input_packet,
+        PooledBuffer&& slab,
+        const uint8_t* overflow,
+        size_t len,
+        const struct sockaddr_in& client_addr)
+{
+    if (len <= slab.size())
+    {
+        input_packet.message.reset(new InputMessage(std::move(slab), len));
+    }
+    else
+    {
+        /* Oversized datagram, stitch slab and overflow together in a dedicated buffer. */
+        PooledBuffer buffer(len);
+        memcpy(buffer.get(), slab.get(), slab.size());
+        memcpy(buffer.get() + slab.size(), overflow, len - slab.size());
+        input_packet.message.reset(new InputMessage(std::move(buffer), len));
+    }
+    input_packet.source = get_endpoint(socket, client_addr);
+}
+
+const std::shared_ptr<EndPoint>& UDPv4Agent::get_endpoint(
+        Socket& socket,
+        const struct sockaddr_in& client_addr)
+{
+    /* Endpoints are immutable, so packets from the same source share a single instance.
+       Each one remembers its socket so that replies leave from where the traffic arrived. */
+    uint32_t addr = client_addr.sin_addr.s_addr;
+    uint16_t port = client_addr.sin_port;
+    uint64_t source_id = (uint64_t(addr) << 16) | port;
+
+    auto it = socket.endpoints.find(source_id);
+    if (socket.endpoints.end() == it)
+    {
+        if (ENDPOINT_CACHE_MAX_SIZE <= socket.endpoints.size())
+        {
+            socket.endpoints.clear();
+        }
+        it = socket.endpoints.emplace(source_id, std::make_shared<IPv4EndPoint>(addr, port, socket.id)).first;
+    }
+    return it->second;
+}
+
 bool UDPv4Agent::send_message(OutputPacket output_packet)
 {
     bool rv = false;
@@ -230,12 +452,17 @@ bool UDPv4Agent::send_message(OutputPacket output_packet)
     client_addr.sin_family = AF_INET;
     client_addr.sin_port = destination->get_port();
     client_addr.sin_addr.s_addr = destination->get_addr();
-    ssize_t bytes_sent = sendto(poll_fd_.fd,
-                                output_packet.message->get_buf(),
-                                output_packet.message->get_len(),
-                                0,
-                                (struct sockaddr*)&client_addr,
-                                sizeof(client_addr));
+    memset(client_addr.sin_zero, '\0', sizeof(client_addr.sin_zero));
+
+    struct iovec iovecs[2];
+    struct msghdr header;
+    memset(&header, 0, sizeof(header));
+    header.msg_name = &client_addr;
+    header.msg_namelen = sizeof(client_addr);
+    header.msg_iov = iovecs;
+    header.msg_iovlen = fill_iovecs(*output_packet.message, iovecs);
+
+    ssize_t bytes_sent = sendmsg(get_socket_fd(output_packet), &header, 0);
     if (-1 != bytes_sent)
     {
         if (size_t(bytes_sent) == output_packet.message->get_len())
@@ -252,6 +479,93 @@ bool UDPv4Agent::send_message(OutputPacket output_packet)
     return rv;
 }
 
+bool UDPv4Agent::send_messages(std::vector<OutputPacket>& output_packets)
+{
+    bool rv = true;
+    const size_t packets_count = output_packets.size();
+    if (send_headers_.size() < packets_count)
+    {
+        send_headers_.resize(packets_count);
+        send_iovecs_.resize(2 * packets_count);
+        send_addrs_.resize(packets_count);
+    }
+
+    /* Batch setup, each datagram gathers the message head and its scattered tail if any. */
+    for (size_t i = 0; i < packets_count; ++i)
+    {
+        const IPv4EndPoint* destination = static_cast<const IPv4EndPoint*>(output_packets[i].destination.get());
+        send_addrs_[i].sin_family = AF_INET;
+        send_addrs_[i].sin_port = destination->get_port();
+        send_addrs_[i].sin_addr.s_addr = destination->get_addr();
+        memset(send_addrs_[i].sin_zero, '\0', sizeof(send_addrs_[i].sin_zero));
+
+        memset(&send_headers_[i], 0, sizeof(struct mmsghdr));
+        send_headers_[i].msg_hdr.msg_name = &send_addrs_[i];
+        send_headers_[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        send_headers_[i].msg_hdr.msg_iov = &send_iovecs_[2 * i];
+        send_headers_[i].msg_hdr.msg_iovlen = fill_iovecs(*output_packets[i].message, &send_iovecs_[2 * i]);
+    }
+
+    /* Flush the batch, one call per run of datagrams leaving from the same socket.
+       A failing datagram is skipped and the rest are retried. */
+    size_t packets_sent = 0;
+    while (packets_sent < packets_count)
+    {
+        const int fd = get_socket_fd(output_packets[packets_sent]);
+        size_t run_end = packets_sent + 1;
+        while ((run_end < packets_count) && (fd == get_socket_fd(output_packets[run_end])))
+        {
+            ++run_end;
+        }
+
+        int sent = sendmmsg(fd, &send_headers_[packets_sent], unsigned(run_end - packets_sent), 0);
+        if (0 < sent)
+        {
+            for (size_t i = packets_sent; i < packets_sent + size_t(sent); ++i)
+            {
+                UXR_AGENT_LOG_MESSAGE(
+                    UXR_DECORATE_YELLOW("[** <<UDP>> **]"),
+                    conversion::clientkey_to_raw(get_client_key(output_packets[i].destination.get())),
+                    output_packets[i].message->get_buf(),
+                    output_packets[i].message->get_len());
+            }
+            packets_sent += size_t(sent);
+        }
+        else
+        {
+            rv = false;
+            ++packets_sent;
+        }
+    }
+    output_packets.clear();
+
+    return rv;
+}
+
+int UDPv4Agent::get_socket_fd(const OutputPacket& output_packet) const
+{
+    /* Endpoints tagged by a previous run with more sockets fall back to the first one. */
+    const IPv4EndPoint* destination = static_cast<const IPv4EndPoint*>(output_packet.destination.get());
+    size_t socket_id = destination->get_socket_id();
+    return sockets_[(socket_id < sockets_.size()) ? socket_id : 0]->poll_fd.fd;
+}
+
+size_t UDPv4Agent::fill_iovecs(
+        const OutputMessage& output_message,
+        struct iovec* iovecs)
+{
+    size_t rv = 1;
+    iovecs[0].iov_base = const_cast<uint8_t*>(output_message.get_head());
+    iovecs[0].iov_len = output_message.get_head_len();
+    if (0 != output_message.get_tail_len())
+    {
+        iovecs[1].iov_base = const_cast<uint8_t*>(output_message.get_tail());
+        iovecs[1].iov_len = output_message.get_tail_len();
+        rv = 2;
+    }
+    return rv;
+}
+
 int UDPv4Agent::get_error()
 {
     return errno;
@@ -27,15 +27,15 @@ TopicPubSubType::TopicPubSubType(bool with_key) {
 bool TopicPubSubType::serialize(void *data, rtps::SerializedPayload_t *payload)
 {
     bool rv = false;
-    std::vector<unsigned char>* buffer = reinterpret_cast<std::vector<unsigned char>*>(data);
+    const ByteView& buffer = reinterpret_cast<const TopicSample*>(data)->view;
     payload->data[0] = 0;
     payload->data[1] = 1;
     payload->data[2] = 0;
     payload->data[3] = 0;
-    if (buffer->size() <= (payload->max_size - 4))
+    if (buffer.size() <= (payload->max_size - 4))
     {
-        memcpy(&payload->data[4], buffer->data(), buffer->size());
-        payload->length = uint32_t(buffer->size() + 4); //Get the serialized length
+        memcpy(&payload->data[4], buffer.data(), buffer.size());
+        payload->length = uint32_t(buffer.size() + 4); //Get the serialized length
         rv = true;
     }
     return rv;
@@ -43,25 +43,30 @@ bool TopicPubSubType::serialize(void *data, rtps::SerializedPayload_t *payload)
 
 bool TopicPubSubType::deserialize(rtps::SerializedPayload_t* payload, void* data)
 {
-    std::vector<unsigned char>* buffer = reinterpret_cast<std::vector<unsigned char>*>(data);
-    buffer->assign(payload->data + 4, payload->data + payload->length);
-
-    return true;
+    /* The payload, past its encapsulation, is lent to the reader instead of being copied. */
+    bool rv = false;
+    const Middleware::OnDataLoan* on_loan = reinterpret_cast<const TopicSample*>(data)->on_loan;
+    if ((4 <= payload->length) && (nullptr != on_loan) && *on_loan)
+    {
+        (*on_loan)(ByteView(payload->data + 4, payload->length - 4));
+        rv = true;
+    }
+    return rv;
 }
 
 std::function<uint32_t()> TopicPubSubType::getSerializedSizeProvider(void* data) {
     return [data]() -> uint32_t
     {
-        return (uint32_t)reinterpret_cast<std::vector<unsigned char>*>(data)->size() + 4 /*encapsulation*/;
+        return (uint32_t)reinterpret_cast<const TopicSample*>(data)->view.size() + 4 /*encapsulation*/;
     };
 }
 
 void* TopicPubSubType::createData() {
-    return (void*)new std::vector<unsigned char>;
+    return (void*)new TopicSample{ByteView(), nullptr};
 }
 
 void TopicPubSubType::deleteData(void* data) {
-    delete((std::vector<unsigned char>*)data);
+    delete((TopicSample*)data);
 }
 
 bool TopicPubSubType::getKey(void *data, rtps::InstanceHandle_t* handle, bool force_md5)
@@ -31,7 +31,10 @@ class ProxyClient
 public:
     explicit ProxyClient(
             const dds::xrce::CLIENT_Representation& /*representation*/,
-            Middleware::Kind /*middleware_kind*/) {}
+            Middleware::Kind /*middleware_kind*/,
+            const StreamDepths& stream_depths)
+        : stream_depths_(stream_depths)
+    {}
 
     ~ProxyClient() = default;
 
@@ -42,6 +45,11 @@ public:
 
     MOCK_METHOD0(get_session_id, dds::xrce::SessionId());
     MOCK_METHOD0(session, Session&());
+
+    StreamDepths get_stream_depths() const { return stream_depths_; }
+
+private:
+    StreamDepths stream_depths_;
 };
 
 } // namespace uxr
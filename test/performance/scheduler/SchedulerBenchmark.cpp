@@ -0,0 +1,97 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Measures the throughput of the server schedulers with several producers and a single consumer.
+ *
+ * usage: bench-scheduler [producers] [elements_per_producer]
+ */
+
+#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+#include <uxr/agent/scheduler/RingScheduler.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Element = std::unique_ptr<uint64_t>;
+
+double run_case(
+        eprosima::uxr::Scheduler<Element>& scheduler,
+        size_t producers_count,
+        size_t elements_per_producer)
+{
+    scheduler.init();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producers_count; ++p)
+    {
+        producers.emplace_back([&scheduler, elements_per_producer]()
+        {
+            for (size_t i = 0; i < elements_per_producer; ++i)
+            {
+                scheduler.push(Element(new uint64_t(i)), 0);
+            }
+        });
+    }
+
+    Element element;
+    for (size_t i = 0; i < producers_count * elements_per_producer; ++i)
+    {
+        scheduler.pop(element);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    scheduler.deinit();
+
+    return double(producers_count * elements_per_producer) / elapsed.count();
+}
+
+} // unnamed namespace
+
+int main(int argc, char** argv)
+{
+    size_t producers_count = (1 < argc) ? size_t(std::strtoul(argv[1], nullptr, 10)) : 4;
+    size_t elements_per_producer = (2 < argc) ? size_t(std::strtoul(argv[2], nullptr, 10)) : 1000000;
+
+    if ((0 == producers_count) || (0 == elements_per_producer))
+    {
+        std::cerr << "usage: " << argv[0] << " [producers] [elements_per_producer]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    /* Both queues are large enough to hold every element, so nothing is dropped. */
+    const size_t max_size = producers_count * elements_per_producer;
+    eprosima::uxr::FCFSScheduler<Element> fcfs_scheduler(max_size);
+    eprosima::uxr::RingScheduler<Element> ring_scheduler(max_size);
+
+    double fcfs_rate = run_case(fcfs_scheduler, producers_count, elements_per_producer);
+    double ring_rate = run_case(ring_scheduler, producers_count, elements_per_producer);
+
+    std::cout << "producers: " << producers_count << std::endl;
+    std::cout << "FCFSScheduler: " << size_t(fcfs_rate) << " elements/s" << std::endl;
+    std::cout << "RingScheduler: " << size_t(ring_rate) << " elements/s" << std::endl;
+
+    return EXIT_SUCCESS;
+}
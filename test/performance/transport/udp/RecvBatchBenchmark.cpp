@@ -0,0 +1,141 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Measures the rate at which a UDPv4Agent on loopback receives datagrams and hands them to its input queues,
+ * reading one datagram per recvmsg call against reading a batch of datagrams per recvmmsg call.
+ * The datagrams come from unknown clients, so the processing workers discard them right away.
+ *
+ * usage: bench-udp-recv-batch [batch_size] [payload_size] [duration_s] [sender_count] [port]
+ */
+
+#include <uxr/agent/transport/udp/UDPServerLinux.hpp>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t MESSAGE_HEADER_SIZE = 8;
+constexpr std::chrono::seconds WARMUP(1);
+
+void sender_task(
+        uint16_t port,
+        size_t payload_size,
+        uint32_t client_key,
+        const std::atomic<bool>& running)
+{
+    int fd = socket(PF_INET, SOCK_DGRAM, 0);
+    if (-1 == fd)
+    {
+        return;
+    }
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    /* Message header with client key on a best-effort stream, the rest of the payload is padding. */
+    std::vector<uint8_t> payload(payload_size, 0x00);
+    payload[0] = 0x01;
+    payload[1] = 0x01;
+    payload[4] = uint8_t(client_key >> 24);
+    payload[5] = uint8_t(client_key >> 16);
+    payload[6] = uint8_t(client_key >> 8);
+    payload[7] = uint8_t(client_key);
+    while (running)
+    {
+        sendto(fd, payload.data(), payload.size(), 0, (struct sockaddr*)&address, sizeof(address));
+    }
+    ::close(fd);
+}
+
+double run_case(
+        size_t batch_size,
+        size_t payload_size,
+        std::chrono::seconds duration,
+        size_t sender_count,
+        uint16_t port)
+{
+    eprosima::uxr::UDPv4Agent agent(port, eprosima::uxr::Middleware::Kind::NONE);
+    agent.set_verbose_level(0);
+    agent.set_recv_batch_size(batch_size);
+    if (!agent.run())
+    {
+        std::cerr << "agent error" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> senders;
+    for (size_t i = 0; i < sender_count; ++i)
+    {
+        senders.emplace_back(sender_task, port, payload_size, uint32_t(0xAABB0000 + i), std::cref(running));
+    }
+
+    std::this_thread::sleep_for(WARMUP);
+    const uint64_t first_received = agent.get_input_received();
+    std::this_thread::sleep_for(duration);
+    const uint64_t last_received = agent.get_input_received();
+
+    running = false;
+    for (auto& sender : senders)
+    {
+        sender.join();
+    }
+    agent.stop();
+
+    return double(last_received - first_received) / double(duration.count());
+}
+
+} // unnamed namespace
+
+int main(int argc, char** argv)
+{
+    size_t batch_size = (1 < argc) ? size_t(std::strtoul(argv[1], nullptr, 10)) : 32;
+    size_t payload_size = (2 < argc) ? size_t(std::strtoul(argv[2], nullptr, 10)) : 64;
+    std::chrono::seconds duration((3 < argc) ? std::strtol(argv[3], nullptr, 10) : 5);
+    size_t sender_count = (4 < argc) ? size_t(std::strtoul(argv[4], nullptr, 10)) : 2;
+    uint16_t port = (5 < argc) ? uint16_t(std::strtoul(argv[5], nullptr, 10)) : 8888;
+
+    if ((0 == batch_size) || (MESSAGE_HEADER_SIZE > payload_size) || (UINT16_MAX < payload_size)
+        || (0 >= duration.count()) || (0 == sender_count))
+    {
+        std::cerr << "usage: " << argv[0] << " [batch_size] [payload_size] [duration_s] [sender_count] [port]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    double single_rate = run_case(1, payload_size, duration, sender_count, port);
+    double batch_rate = run_case(batch_size, payload_size, duration, sender_count, port);
+
+    std::cout << "payload size: " << payload_size << " bytes" << std::endl;
+    std::cout << "recvmsg:               " << size_t(single_rate) << " pkts/s" << std::endl;
+    std::cout << "recvmmsg (batch " << batch_size << "): " << size_t(batch_rate) << " pkts/s" << std::endl;
+
+    return EXIT_SUCCESS;
+}
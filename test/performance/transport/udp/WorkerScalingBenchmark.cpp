@@ -0,0 +1,186 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Measures the rate at which a UDPv4Agent on loopback processes messages from many clients
+ * as the number of processing workers grows from one to max_workers.
+ * Each message carries a HEARTBEAT, so every one of them is answered with an ACKNACK.
+ * The processed rate is the rate of packets queued to the workers minus the rate of packets dropped
+ * because the workers fell behind.
+ *
+ * usage: bench-udp-worker-scaling [max_workers] [client_count] [duration_s] [sender_count] [port]
+ */
+
+#include <uxr/agent/transport/udp/UDPServerLinux.hpp>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t FIRST_CLIENT_KEY = 0xAABB0000;
+constexpr uint8_t SESSION_ID = 0x01;
+constexpr uint16_t MTU = 512;
+constexpr size_t RECV_BATCH_SIZE = 32;
+constexpr std::chrono::seconds WARMUP(1);
+
+/* Message header with client key on the none stream, followed by a HEARTBEAT of the builtin reliable stream. */
+std::vector<uint8_t> generate_message(uint32_t client_key)
+{
+    return std::vector<uint8_t>{
+        SESSION_ID, 0x00, 0x00, 0x00,
+        uint8_t(client_key >> 24), uint8_t(client_key >> 16), uint8_t(client_key >> 8), uint8_t(client_key),
+        0x0B, 0x01, 0x05, 0x00,
+        0x00, 0x00, 0xFF, 0xFF, 0x80};
+}
+
+void sender_task(
+        uint16_t port,
+        size_t first_client,
+        size_t client_count,
+        const std::atomic<bool>& running)
+{
+    int fd = socket(PF_INET, SOCK_DGRAM, 0);
+    if (-1 == fd)
+    {
+        return;
+    }
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    std::vector<std::vector<uint8_t>> messages;
+    for (size_t i = 0; i < client_count; ++i)
+    {
+        messages.push_back(generate_message(uint32_t(FIRST_CLIENT_KEY + first_client + i)));
+    }
+
+    /* The replies are left unread, the kernel drops them once the socket buffer is full. */
+    size_t index = 0;
+    while (running)
+    {
+        const std::vector<uint8_t>& message = messages[index];
+        sendto(fd, message.data(), message.size(), 0, (struct sockaddr*)&address, sizeof(address));
+        index = (index + 1) % messages.size();
+    }
+    ::close(fd);
+}
+
+double run_case(
+        size_t worker_count,
+        size_t client_count,
+        std::chrono::seconds duration,
+        size_t sender_count,
+        uint16_t port)
+{
+    eprosima::uxr::UDPv4Agent agent(port, eprosima::uxr::Middleware::Kind::CED);
+    agent.set_verbose_level(0);
+    agent.set_recv_batch_size(RECV_BATCH_SIZE);
+    agent.set_worker_count(worker_count);
+    if (!agent.run())
+    {
+        std::cerr << "agent error" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    eprosima::uxr::Agent::OpResult result;
+    for (size_t i = 0; i < client_count; ++i)
+    {
+        agent.create_client(uint32_t(FIRST_CLIENT_KEY + i), SESSION_ID, MTU, eprosima::uxr::Middleware::Kind::CED, result);
+    }
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> senders;
+    const size_t clients_per_sender = (client_count + sender_count - 1) / sender_count;
+    for (size_t first_client = 0; first_client < client_count; first_client += clients_per_sender)
+    {
+        senders.emplace_back(
+            sender_task,
+            port,
+            first_client,
+            std::min(clients_per_sender, client_count - first_client),
+            std::cref(running));
+    }
+
+    std::this_thread::sleep_for(WARMUP);
+    const uint64_t first_processed = agent.get_input_received() - agent.get_input_dropped();
+    std::this_thread::sleep_for(duration);
+    const uint64_t last_processed = agent.get_input_received() - agent.get_input_dropped();
+
+    running = false;
+    for (auto& sender : senders)
+    {
+        sender.join();
+    }
+    for (size_t i = 0; i < client_count; ++i)
+    {
+        agent.delete_client(uint32_t(FIRST_CLIENT_KEY + i), result);
+    }
+    agent.stop();
+
+    return double(last_processed - first_processed) / double(duration.count());
+}
+
+} // unnamed namespace
+
+int main(int argc, char** argv)
+{
+    size_t max_workers = (1 < argc) ? size_t(std::strtoul(argv[1], nullptr, 10)) : 4;
+    size_t client_count = (2 < argc) ? size_t(std::strtoul(argv[2], nullptr, 10)) : 64;
+    std::chrono::seconds duration((3 < argc) ? std::strtol(argv[3], nullptr, 10) : 5);
+    size_t sender_count = (4 < argc) ? size_t(std::strtoul(argv[4], nullptr, 10)) : 2;
+    uint16_t port = (5 < argc) ? uint16_t(std::strtoul(argv[5], nullptr, 10)) : 8888;
+
+    if ((0 == max_workers) || (0 == client_count) || (0 >= duration.count())
+        || (0 == sender_count) || (client_count < sender_count))
+    {
+        std::cerr << "usage: " << argv[0] << " [max_workers] [client_count] [duration_s] [sender_count] [port]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "clients: " << client_count << std::endl;
+    double single_rate = 0.0;
+    for (size_t worker_count = 1; worker_count <= max_workers; ++worker_count)
+    {
+        double rate = run_case(worker_count, client_count, duration, sender_count, port);
+        if (1 == worker_count)
+        {
+            single_rate = rate;
+        }
+        std::cout << "workers " << worker_count << ": " << size_t(rate) << " msgs/s";
+        if (0.0 < single_rate)
+        {
+            std::cout << " (x" << rate / single_rate << ")";
+        }
+        std::cout << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -19,6 +19,7 @@
 #include <uxr/agent/client/ProxyClient.hpp>
 #include <uxr/agent/types/MessageHeader.hpp>
 #include <uxr/agent/types/SubMessageHeader.hpp>
+#include <uxr/agent/utils/Conversion.hpp>
 
 #include <gtest/gtest.h>
 
@@ -85,6 +86,48 @@ TEST_F(RootTests, CreateClientIncompatibleVersion)
     ASSERT_EQ(dds::xrce::STATUS_ERR_INCOMPATIBLE, response.status());
 }
 
+TEST_F(RootTests, CreateClientStreamDepths)
+{
+    dds::xrce::CREATE_CLIENT_Payload create_data = generate_create_client_payload();
+    dds::xrce::AGENT_Representation agent_representation;
+    dds::xrce::ResultStatus response = root_.create_client(
+                create_data.client_representation(),
+                agent_representation,
+                Middleware::Kind::FAST);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_FALSE(agent_representation.properties());
+    ASSERT_EQ(RELIABLE_STREAM_DEPTH, root_.get_client(client_key)->get_stream_depths().reliable);
+
+    /* Invalid depths keep the default, and too deep ones are limited. */
+    dds::xrce::PropertySeq properties(2);
+    properties[0].name(BEST_EFFORT_DEPTH_PROPERTY);
+    properties[0].value("0");
+    properties[1].name(RELIABLE_DEPTH_PROPERTY);
+    properties[1].value("100000");
+    create_data.client_representation().properties(properties);
+    response = root_.create_client(
+                create_data.client_representation(),
+                agent_representation,
+                Middleware::Kind::FAST);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_EQ(BEST_EFFORT_STREAM_DEPTH, root_.get_client(client_key)->get_stream_depths().best_effort);
+    ASSERT_EQ(MAX_STREAM_DEPTH, root_.get_client(client_key)->get_stream_depths().reliable);
+    ASSERT_TRUE(agent_representation.properties());
+    ASSERT_EQ(std::to_string(MAX_STREAM_DEPTH), agent_representation.properties()->at(1).value());
+
+    /* Negative and padded depths are malformed, they keep the default. */
+    properties[0].value(" 8");
+    properties[1].value("-1");
+    create_data.client_representation().properties(properties);
+    response = root_.create_client(
+                create_data.client_representation(),
+                agent_representation,
+                Middleware::Kind::FAST);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_EQ(BEST_EFFORT_STREAM_DEPTH, root_.get_client(client_key)->get_stream_depths().best_effort);
+    ASSERT_EQ(RELIABLE_STREAM_DEPTH, root_.get_client(client_key)->get_stream_depths().reliable);
+}
+
 TEST_F(RootTests, DeleteExistingClient)
 {
     dds::xrce::CREATE_CLIENT_Payload create_data = generate_create_client_payload();
@@ -121,6 +164,26 @@ TEST_F(RootTests, DeleteNoExistingClient)
     ASSERT_EQ(dds::xrce::STATUS_ERR_UNKNOWN_REFERENCE, response.status());
 }
 
+TEST_F(RootTests, ClientsSnapshot)
+{
+    dds::xrce::AGENT_Representation agent_representation;
+    dds::xrce::ResultStatus response = root_.create_client(
+                generate_create_client_payload().client_representation(),
+                agent_representation,
+                Middleware::Kind::FAST);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_EQ(root_.get_client(client_key), root_.get_client(conversion::clientkey_to_raw(client_key)));
+
+    /* A snapshot keeps the deleted client alive. */
+    std::shared_ptr<const Root::ClientMap> clients = root_.get_clients();
+    response = root_.delete_client(client_key);
+    ASSERT_EQ(dds::xrce::STATUS_OK, response.status());
+    ASSERT_EQ(1u, clients->size());
+    ASSERT_TRUE(clients->at(conversion::clientkey_to_raw(client_key)));
+    ASSERT_TRUE(root_.get_clients()->empty());
+    ASSERT_FALSE(root_.get_client(client_key));
+}
+
 /*
 class ProxyClientTests : public CommonData, public ::testing::Test
 {
@@ -0,0 +1,191 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/client/session/Session.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+constexpr dds::xrce::SessionId session_id = 0x01;
+constexpr dds::xrce::ClientKey client_key = {0xAA, 0xBB, 0xCC, 0xDD};
+constexpr size_t mtu = 512;
+
+/* Stream counting its instances, so that the streams dropped by a race can be told apart. */
+struct CountedStream
+{
+    explicit CountedStream(uint16_t depth)
+        : depth(depth)
+    {
+        ++created;
+    }
+
+    ~CountedStream()
+    {
+        ++destroyed;
+    }
+
+    const uint16_t depth;
+    static std::atomic<int> created;
+    static std::atomic<int> destroyed;
+};
+
+std::atomic<int> CountedStream::created{0};
+std::atomic<int> CountedStream::destroyed{0};
+
+class StreamTableTest : public ::testing::Test
+{
+protected:
+    StreamTableTest()
+    {
+        CountedStream::created = 0;
+        CountedStream::destroyed = 0;
+    }
+};
+
+/**
+ * @brief   This test checks that concurrent first uses of a stream all get the same stream,
+ *          and that the streams of the threads losing the race are released.
+ */
+TEST_F(StreamTableTest, ConcurrentFirstGet)
+{
+    constexpr size_t thread_count = 8;
+    constexpr size_t stream_count = 128;
+    {
+        StreamTable<CountedStream> table(16);
+        std::atomic<bool> start{false};
+        std::vector<std::vector<CountedStream*>> streams(thread_count, std::vector<CountedStream*>(stream_count));
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([&table, &start, &streams, i]()
+            {
+                while (!start)
+                {
+                    std::this_thread::yield();
+                }
+                for (size_t j = 0; j < stream_count; ++j)
+                {
+                    streams[i][j] = &table.get(dds::xrce::StreamId(j));
+                }
+            });
+        }
+        start = true;
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (size_t j = 0; j < stream_count; ++j)
+        {
+            ASSERT_EQ(16, streams[0][j]->depth);
+            for (size_t i = 1; i < thread_count; ++i)
+            {
+                ASSERT_EQ(streams[0][j], streams[i][j]);
+            }
+        }
+        ASSERT_EQ(int(stream_count), CountedStream::created - CountedStream::destroyed);
+    }
+    ASSERT_EQ(CountedStream::created.load(), CountedStream::destroyed.load());
+}
+
+/**
+ * @brief   This test checks that the streams are visited with their id, once each, and only once created.
+ */
+TEST_F(StreamTableTest, ForEach)
+{
+    StreamTable<CountedStream> table(16);
+    std::vector<dds::xrce::StreamId> stream_ids;
+    auto collect = [&stream_ids](dds::xrce::StreamId stream_id, CountedStream&)
+    {
+        stream_ids.push_back(stream_id);
+    };
+
+    table.for_each(dds::xrce::STREAMID_BUILTIN_RELIABLE, collect);
+    ASSERT_TRUE(stream_ids.empty());
+
+    table.get(0xFF);
+    table.get(0x80);
+    table.get(0x85);
+    table.get(0x85);
+    table.for_each(dds::xrce::STREAMID_BUILTIN_RELIABLE, collect);
+    ASSERT_EQ(std::vector<dds::xrce::StreamId>({0x80, 0x85, 0xFF}), stream_ids);
+
+    stream_ids.clear();
+    table.for_each(0x00, collect);
+    ASSERT_EQ(std::vector<dds::xrce::StreamId>({0x00, 0x05, 0x7F}), stream_ids);
+}
+
+/**
+ * @brief   This test checks that the output streams of a session are the reliable streams used so far.
+ */
+TEST(SessionTest, GetOutputStreams)
+{
+    Session session(SessionInfo{client_key, session_id, mtu});
+    ASSERT_TRUE(session.get_output_streams().empty());
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    session.push_output_submessage(dds::xrce::STREAMID_NONE, dds::xrce::WRITE_DATA, write_data);
+    session.push_output_submessage(dds::xrce::STREAMID_BUILTIN_BEST_EFFORTS, dds::xrce::WRITE_DATA, write_data);
+    ASSERT_TRUE(session.get_output_streams().empty());
+
+    session.push_output_submessage(0x85, dds::xrce::WRITE_DATA, write_data);
+    session.push_output_submessage(dds::xrce::STREAMID_BUILTIN_RELIABLE, dds::xrce::WRITE_DATA, write_data);
+    session.push_output_submessage(0x85, dds::xrce::WRITE_DATA, write_data);
+    ASSERT_EQ(std::vector<uint8_t>({dds::xrce::STREAMID_BUILTIN_RELIABLE, 0x85}), session.get_output_streams());
+}
+
+/**
+ * @brief   This test checks that a reassembled message is only popped from the reliable stream
+ *          which received its fragments, and not from the best-effort stream sharing its index.
+ */
+TEST(SessionTest, FragmentStreams)
+{
+    Session session(SessionInfo{client_key, session_id, mtu});
+
+    /* Message header and a last FRAGMENT subheader with its payload. */
+    std::vector<uint8_t> raw{session_id, 0x85, 0x00, 0x00, 0xAA, 0xBB, 0xCC, 0xDD};
+    raw.push_back(dds::xrce::FRAGMENT);
+    raw.push_back(uint8_t(0x01 | dds::xrce::FLAG_LAST_FRAGMENT));
+    raw.push_back(0x04);
+    raw.push_back(0x00);
+    raw.insert(raw.end(), 4, 0x55);
+    InputMessagePtr message(new InputMessage(raw.data(), raw.size()));
+    ASSERT_TRUE(message->prepare_next_submessage());
+
+    session.push_input_fragment(0x05, message);
+    ASSERT_FALSE(session.pop_input_fragment_message(0x85, message));
+
+    session.push_input_fragment(0x85, message);
+    ASSERT_FALSE(session.pop_input_fragment_message(0x05, message));
+    ASSERT_TRUE(session.pop_input_fragment_message(0x85, message));
+    ASSERT_EQ(raw.size() - 4, message->get_len());
+    ASSERT_FALSE(session.pop_input_fragment_message(0x85, message));
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
@@ -290,6 +290,16 @@ TEST_F(ReliableInputStreamTest, BorderCases)
     ASSERT_TRUE(reliable_stream_.emplace_message(RELIABLE_STREAM_DEPTH - 1, buf, sizeof(buf)));
 }
 
+TEST_F(ReliableInputStreamTest, RuntimeDepth)
+{
+    uint8_t buf[128] = {0};
+    const uint16_t depth = 4 * RELIABLE_STREAM_DEPTH;
+    ReliableInputStream reliable_stream(depth);
+
+    ASSERT_FALSE(reliable_stream.emplace_message(depth, buf, sizeof(buf)));
+    ASSERT_TRUE(reliable_stream.emplace_message(depth - 1, buf, sizeof(buf)));
+}
+
 TEST_F(ReliableInputStreamTest, UpdateFromHeartbeat)
 {
     uint8_t buf[128] = {0};
@@ -340,6 +350,84 @@ TEST_F(ReliableInputStreamTest, FillAcknack)
     }
 }
 
+TEST_F(ReliableInputStreamTest, Wraparound)
+{
+    uint8_t buf[128] = {0};
+    InputMessagePtr input_message;
+
+    /* Messages are kept in order across the sequence number wraparound. */
+    reliable_stream_.update_from_heartbeat(0x7FFF, 0x7FFF);
+    reliable_stream_.update_from_heartbeat(0xFFFE, 0xFFFF);
+    for (uint16_t i = 0; i < RELIABLE_STREAM_DEPTH; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.emplace_message(uint16_t(0xFFFE + RELIABLE_STREAM_DEPTH - 1 - i),
+                                                     buf, sizeof(buf)));
+    }
+    ASSERT_FALSE(reliable_stream_.emplace_message(uint16_t(0xFFFE + RELIABLE_STREAM_DEPTH), buf, sizeof(buf)));
+    for (uint16_t i = 0; i < RELIABLE_STREAM_DEPTH; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.pop_message(input_message));
+    }
+    ASSERT_FALSE(reliable_stream_.pop_message(input_message));
+
+    /* A message skipped by a heartbeat is not handled when its slot comes round again. */
+    const SeqNum skipped = uint16_t(0xFFFE + RELIABLE_STREAM_DEPTH + 1);
+    ASSERT_TRUE(reliable_stream_.emplace_message(skipped, buf, sizeof(buf)));
+    reliable_stream_.update_from_heartbeat(skipped + 1, skipped + 1);
+    ASSERT_FALSE(reliable_stream_.pop_message(input_message));
+    ASSERT_TRUE(reliable_stream_.emplace_message(skipped + 1, buf, sizeof(buf)));
+    ASSERT_TRUE(reliable_stream_.pop_message(input_message));
+    ASSERT_FALSE(reliable_stream_.emplace_message(skipped, buf, sizeof(buf)));
+}
+
+TEST_F(ReliableInputStreamTest, Fragments)
+{
+    const SessionInfo session_info{{0xAA, 0xBB, 0xCC, 0xDD}, 0x01, 512};
+
+    /* Message header, FRAGMENT subheader and as many payload bytes as the fragment number plus one. */
+    auto make_fragment = [](uint8_t index, bool last)
+    {
+        std::vector<uint8_t> raw{0x01, 0x80, 0x00, 0x00, 0xAA, 0xBB, 0xCC, 0xDD};
+        const uint8_t size = uint8_t(200 + index);
+        raw.push_back(dds::xrce::FRAGMENT);
+        raw.push_back(uint8_t(0x01 | (last ? dds::xrce::FLAG_LAST_FRAGMENT : 0x00)));
+        raw.push_back(size);
+        raw.push_back(0x00);
+        raw.insert(raw.end(), size, index);
+        InputMessagePtr message(new InputMessage(raw.data(), raw.size()));
+        EXPECT_TRUE(message->prepare_next_submessage());
+        return message;
+    };
+
+    for (int round = 0; round < 2; ++round)
+    {
+        InputMessagePtr message;
+        const uint8_t count = uint8_t(round ? 3 : 8);
+        size_t expected_len = 8;
+        for (uint8_t i = 0; i < count; ++i)
+        {
+            ASSERT_FALSE(reliable_stream_.pop_fragment_message(message));
+            message = make_fragment(i, i + 1 == count);
+            reliable_stream_.push_fragment(session_info, message);
+            expected_len += 200 + i;
+        }
+        ASSERT_TRUE(reliable_stream_.pop_fragment_message(message));
+        ASSERT_FALSE(reliable_stream_.pop_fragment_message(message));
+
+        /* Header of the first fragment followed by every fragment payload. */
+        ASSERT_EQ(expected_len, message->get_len());
+        ASSERT_EQ(0x01, message->get_header().session_id());
+        const uint8_t* data = message->get_buf() + 8;
+        for (uint8_t i = 0; i < count; ++i)
+        {
+            for (size_t j = 0; j < size_t(200 + i); ++j)
+            {
+                ASSERT_EQ(i, *data++);
+            }
+        }
+    }
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
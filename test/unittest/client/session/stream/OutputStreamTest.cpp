@@ -144,6 +144,45 @@ TEST_F(BestEffortOutputStreamTest, MaximumMessageSize)
     ASSERT_FALSE(best_effort_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
 }
 
+/**
+ * @brief   This test checks that coalesced submessages are packed in one message up to the MTU,
+ *          and that the open message is only popped on flush or once another message follows it.
+ */
+TEST_F(BestEffortOutputStreamTest, Coalescing)
+{
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    write_data.data().serialized_data().resize(100);
+
+    OutputMessagePtr output_message;
+    SeqNum first_seq_num;
+    SeqNum seq_num;
+    ASSERT_FALSE(best_effort_stream_.arm_flush(first_seq_num));
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(best_effort_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    }
+    ASSERT_TRUE(best_effort_stream_.arm_flush(first_seq_num));
+    ASSERT_FALSE(best_effort_stream_.arm_flush(seq_num));
+    ASSERT_TRUE(best_effort_stream_.is_flush_armed(first_seq_num));
+    ASSERT_FALSE(best_effort_stream_.pop_message(output_message, false));
+
+    /* The fifth submessage does not fit, the first message is closed. */
+    ASSERT_TRUE(best_effort_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    ASSERT_TRUE(best_effort_stream_.pop_message(output_message, false));
+    ASSERT_LE(4 * 100, output_message->get_len());
+    ASSERT_GE(mtu, output_message->get_len());
+    ASSERT_FALSE(best_effort_stream_.pop_message(output_message, false));
+
+    /* The flush armed for the first message does not apply to the second one. */
+    ASSERT_FALSE(best_effort_stream_.is_flush_armed(first_seq_num));
+    ASSERT_TRUE(best_effort_stream_.arm_flush(seq_num));
+    ASSERT_TRUE(best_effort_stream_.is_flush_armed(seq_num));
+    ASSERT_TRUE(best_effort_stream_.pop_message(output_message));
+    ASSERT_GT(2 * 100, output_message->get_len());
+    ASSERT_FALSE(best_effort_stream_.is_flush_armed(seq_num));
+    ASSERT_FALSE(best_effort_stream_.arm_flush(seq_num));
+}
+
 /****************************************************************************************
  * Reliable Output Stream.
  ****************************************************************************************/
@@ -270,6 +309,43 @@ TEST_F(ReliableOutputStreamTest, Fragmentation)
     }
 }
 
+/**
+ * @brief   This test checks that a submessage fragmented beyond the depth keeps every fragment,
+ *          and that the stream gets back to its depth once they are acknowledged.
+ */
+TEST_F(ReliableOutputStreamTest, FragmentationBeyondDepth)
+{
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    write_data.data().serialized_data().resize(4 * RELIABLE_STREAM_DEPTH * mtu);
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+
+    OutputMessagePtr output_message;
+    OutputMessagePtr retransmitted_message;
+    SeqNum seq_num = 0;
+    while (reliable_stream_.get_next_message(output_message))
+    {
+        ASSERT_TRUE(reliable_stream_.get_message(seq_num, retransmitted_message));
+        ASSERT_EQ(output_message, retransmitted_message);
+        seq_num += 1;
+    }
+    ASSERT_LT(SeqNum(4 * RELIABLE_STREAM_DEPTH), seq_num);
+    reliable_stream_.update_from_acknack(seq_num);
+
+    write_data.data().serialized_data().resize(0);
+    for (int i = 0; i < RELIABLE_STREAM_DEPTH; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    }
+    ASSERT_FALSE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    for (int i = 0; i < RELIABLE_STREAM_DEPTH; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+        ASSERT_TRUE(reliable_stream_.get_message(seq_num, retransmitted_message));
+        ASSERT_EQ(output_message, retransmitted_message);
+        seq_num += 1;
+    }
+}
+
 /**
  * @brief   This test checks the initial conditions of the reliable stream.
  */
@@ -286,7 +362,7 @@ TEST_F(ReliableOutputStreamTest, InitialCondition)
 
 /**
  * @brief   This test checks that the reliable stream is promoted properly when messages are pushed.
- *          The last_unacked shall increase by one for each pushed message.
+ *          The last_unacked shall increase by one for each pushed message once it is sent.
  */
 TEST_F(ReliableOutputStreamTest, PushMessages)
 {
@@ -296,6 +372,13 @@ TEST_F(ReliableOutputStreamTest, PushMessages)
 
     dds::xrce::WRITE_DATA_Payload_Data write_data{};
     ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+
+    reliable_stream_.fill_heartbeat(hearbeat);
+    ASSERT_EQ(hearbeat.first_unacked_seq_nr(), expected_first_unacked);
+    ASSERT_EQ(hearbeat.last_unacked_seq_nr(), expected_last_unacked);
+
+    OutputMessagePtr output_message;
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
     expected_last_unacked += 1;
 
     reliable_stream_.fill_heartbeat(hearbeat);
@@ -303,6 +386,7 @@ TEST_F(ReliableOutputStreamTest, PushMessages)
     ASSERT_EQ(hearbeat.last_unacked_seq_nr(), expected_last_unacked);
 
     ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
     expected_last_unacked += 1;
 
     reliable_stream_.fill_heartbeat(hearbeat);
@@ -357,13 +441,13 @@ TEST_F(ReliableOutputStreamTest, UpdateFromAcknack)
     reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data);
     reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data);
     reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data);
-    expected_last_unacked += 4;
 
     OutputMessagePtr output_message;
     reliable_stream_.get_next_message(output_message);
     reliable_stream_.get_next_message(output_message);
     reliable_stream_.get_next_message(output_message);
     last_sent += 3;
+    expected_last_unacked += 3;
 
     /*
      * Lower border case.
@@ -394,6 +478,181 @@ TEST_F(ReliableOutputStreamTest, UpdateFromAcknack)
     ASSERT_EQ(hearbeat.last_unacked_seq_nr(), expected_last_unacked);
 }
 
+/**
+ * @brief   This test checks that the heartbeat timer is armed once while there are unacknowledged messages.
+ */
+TEST_F(ReliableOutputStreamTest, ArmHeartbeat)
+{
+    dds::xrce::HEARTBEAT_Payload hearbeat;
+    ASSERT_FALSE(reliable_stream_.arm_heartbeat());
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    ASSERT_TRUE(reliable_stream_.arm_heartbeat());
+    ASSERT_FALSE(reliable_stream_.arm_heartbeat());
+
+    /* The timer keeps running until every message is acknowledged. */
+    ASSERT_TRUE(reliable_stream_.fill_heartbeat(hearbeat));
+    ASSERT_FALSE(reliable_stream_.arm_heartbeat());
+
+    OutputMessagePtr output_message;
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    ASSERT_TRUE(reliable_stream_.fill_heartbeat(hearbeat));
+    reliable_stream_.update_from_acknack(hearbeat.last_unacked_seq_nr() + 1);
+    ASSERT_FALSE(reliable_stream_.fill_heartbeat(hearbeat));
+
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    ASSERT_TRUE(reliable_stream_.arm_heartbeat());
+}
+
+/**
+ * @brief   This test checks that unanswered heartbeats back the heartbeat period off,
+ *          and that an answered heartbeat brings it back to the measured round trip.
+ */
+TEST_F(ReliableOutputStreamTest, HeartbeatPeriod)
+{
+    dds::xrce::HEARTBEAT_Payload hearbeat;
+    ASSERT_EQ(std::chrono::milliseconds(HEARTBEAT_PERIOD), reliable_stream_.get_heartbeat_period());
+
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    OutputMessagePtr output_message;
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+
+    ASSERT_TRUE(reliable_stream_.fill_heartbeat(hearbeat));
+    ASSERT_TRUE(reliable_stream_.fill_heartbeat(hearbeat));
+    ASSERT_EQ(std::chrono::milliseconds(std::min(2 * HEARTBEAT_PERIOD, int(MAX_HEARTBEAT_PERIOD))),
+              reliable_stream_.get_heartbeat_period());
+
+    /* Ambiguous round trip, the backoff is kept. */
+    reliable_stream_.update_from_acknack(hearbeat.first_unacked_seq_nr());
+    ASSERT_EQ(std::chrono::milliseconds(std::min(2 * HEARTBEAT_PERIOD, int(MAX_HEARTBEAT_PERIOD))),
+              reliable_stream_.get_heartbeat_period());
+
+    /* Immediate answer, the period falls to the minimum. */
+    ASSERT_TRUE(reliable_stream_.fill_heartbeat(hearbeat));
+    reliable_stream_.update_from_acknack(hearbeat.last_unacked_seq_nr() + 1);
+    ASSERT_EQ(std::chrono::milliseconds(MIN_HEARTBEAT_PERIOD), reliable_stream_.get_heartbeat_period());
+}
+
+/**
+ * @brief   This test checks that coalesced submessages share the sequence number of the open message,
+ *          and that the open message is only handed out once.
+ */
+TEST_F(ReliableOutputStreamTest, Coalescing)
+{
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    write_data.data().serialized_data().resize(100);
+
+    OutputMessagePtr output_message;
+    OutputMessagePtr retransmitted_message;
+    SeqNum seq_num;
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    }
+    ASSERT_TRUE(reliable_stream_.arm_flush(seq_num));
+    ASSERT_EQ(SeqNum(0), seq_num);
+    ASSERT_FALSE(reliable_stream_.get_next_message(output_message, false));
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    ASSERT_LE(4 * 100, output_message->get_len());
+    ASSERT_FALSE(reliable_stream_.get_message(1, retransmitted_message));
+    ASSERT_FALSE(reliable_stream_.is_flush_armed(seq_num));
+    ASSERT_FALSE(reliable_stream_.arm_flush(seq_num));
+
+    /* A sent message is never appended to. */
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    ASSERT_TRUE(reliable_stream_.arm_flush(seq_num));
+    ASSERT_EQ(SeqNum(1), seq_num);
+    ASSERT_FALSE(reliable_stream_.get_message(1, retransmitted_message));
+    ASSERT_TRUE(reliable_stream_.is_flush_armed(seq_num));
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    ASSERT_FALSE(reliable_stream_.get_next_message(output_message, false));
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    ASSERT_LE(3 * 100, output_message->get_len());
+    ASSERT_FALSE(reliable_stream_.is_flush_armed(seq_num));
+    ASSERT_FALSE(reliable_stream_.get_next_message(output_message));
+    ASSERT_TRUE(reliable_stream_.get_message(1, retransmitted_message));
+    ASSERT_EQ(retransmitted_message, output_message);
+}
+
+/**
+ * @brief   This test checks that a heartbeat only announces sent messages,
+ *          so that the message open to coalescing is neither NACKed nor sent twice.
+ */
+TEST_F(ReliableOutputStreamTest, CoalescingHeartbeat)
+{
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    write_data.data().serialized_data().resize(100);
+    dds::xrce::HEARTBEAT_Payload hearbeat;
+
+    OutputMessagePtr output_message;
+    OutputMessagePtr retransmitted_message;
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    ASSERT_TRUE(reliable_stream_.fill_heartbeat(hearbeat));
+    ASSERT_EQ(SeqNum(0x0000), hearbeat.first_unacked_seq_nr());
+    ASSERT_EQ(SeqNum(0xFFFF), hearbeat.last_unacked_seq_nr());
+    ASSERT_FALSE(reliable_stream_.get_message(0, retransmitted_message));
+
+    ASSERT_TRUE(reliable_stream_.get_next_message(output_message));
+    ASSERT_FALSE(reliable_stream_.get_next_message(output_message));
+    ASSERT_TRUE(reliable_stream_.fill_heartbeat(hearbeat));
+    ASSERT_EQ(SeqNum(0x0000), hearbeat.first_unacked_seq_nr());
+    ASSERT_EQ(SeqNum(0x0000), hearbeat.last_unacked_seq_nr());
+    ASSERT_TRUE(reliable_stream_.get_message(0, retransmitted_message));
+    ASSERT_EQ(output_message, retransmitted_message);
+
+    /* A second message opened after the first one is sent stays out of the announced range. */
+    ASSERT_TRUE(reliable_stream_.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data, true));
+    ASSERT_TRUE(reliable_stream_.fill_heartbeat(hearbeat));
+    ASSERT_EQ(SeqNum(0x0000), hearbeat.last_unacked_seq_nr());
+    ASSERT_FALSE(reliable_stream_.get_message(1, retransmitted_message));
+}
+
+/**
+ * @brief   This test checks a stream with a runtime depth across the sequence number wraparound.
+ *          Retransmission lookups shall only find the unacknowledged messages.
+ */
+TEST_F(ReliableOutputStreamTest, RuntimeDepth)
+{
+    const int depth = 5;
+    ReliableOutputStream reliable_stream(depth);
+    dds::xrce::WRITE_DATA_Payload_Data write_data{};
+    OutputMessagePtr output_message;
+    OutputMessagePtr retransmitted_message;
+
+    for (int i = 0; i < depth; ++i)
+    {
+        ASSERT_TRUE(reliable_stream.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    }
+    ASSERT_FALSE(reliable_stream.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+    for (int i = 0; i < depth; ++i)
+    {
+        ASSERT_TRUE(reliable_stream.get_next_message(output_message));
+    }
+    reliable_stream.update_from_acknack(SeqNum(depth));
+
+    SeqNum seq_num = depth;
+    for (int i = 0; i < 70000; ++i)
+    {
+        ASSERT_TRUE(reliable_stream.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+        ASSERT_TRUE(reliable_stream.push_submessage(session_info_, stream_id_, dds::xrce::WRITE_DATA, write_data));
+        ASSERT_TRUE(reliable_stream.get_next_message(output_message));
+        ASSERT_TRUE(reliable_stream.get_message(seq_num, retransmitted_message));
+        ASSERT_EQ(output_message, retransmitted_message);
+        ASSERT_TRUE(reliable_stream.get_next_message(output_message));
+        ASSERT_TRUE(reliable_stream.get_message(seq_num + 1, retransmitted_message));
+        ASSERT_EQ(output_message, retransmitted_message);
+
+        reliable_stream.update_from_acknack(seq_num + 1);
+        ASSERT_FALSE(reliable_stream.get_message(seq_num, retransmitted_message));
+        reliable_stream.update_from_acknack(seq_num + 2);
+        ASSERT_FALSE(reliable_stream.get_message(seq_num + 1, retransmitted_message));
+        seq_num += 2;
+    }
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
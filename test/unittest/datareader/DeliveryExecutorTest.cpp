@@ -0,0 +1,140 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/datareader/DeliveryExecutor.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class DeliveryExecutorTest : public ::testing::Test
+{
+protected:
+    DeliveryExecutorTest()
+        : executor_(2)
+        , done_(0)
+    {}
+
+    void wait_done(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        ASSERT_TRUE(cond_var_.wait_for(lock, std::chrono::seconds(5), [&]() { return done_ >= count; }));
+    }
+
+    void set_done()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ++done_;
+        cond_var_.notify_all();
+    }
+
+    DeliveryExecutor executor_;
+    size_t done_;
+    std::mutex mtx_;
+    std::condition_variable cond_var_;
+};
+
+TEST_F(DeliveryExecutorTest, Post)
+{
+    ASSERT_EQ(2u, executor_.get_thread_count());
+
+    std::atomic<size_t> counter{0};
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        executor_.post([&]()
+        {
+            ++counter;
+            set_done();
+        });
+    }
+    wait_done(1000);
+    ASSERT_EQ(1000u, counter.load());
+}
+
+TEST_F(DeliveryExecutorTest, PostAt)
+{
+    auto now = std::chrono::steady_clock::now();
+    std::vector<int> order;
+    std::chrono::steady_clock::time_point run_time;
+
+    /* Timed tasks run by deadline, not by posting order. */
+    executor_.post_at(now + std::chrono::milliseconds(60), [&]()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        order.push_back(2);
+        run_time = std::chrono::steady_clock::now();
+        ++done_;
+        cond_var_.notify_all();
+    });
+    executor_.post_at(now + std::chrono::milliseconds(20), [&]()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        order.push_back(1);
+        ++done_;
+        cond_var_.notify_all();
+    });
+    wait_done(2);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    ASSERT_EQ((std::vector<int>{1, 2}), order);
+    ASSERT_GE(run_time, now + std::chrono::milliseconds(60));
+}
+
+TEST_F(DeliveryExecutorTest, ThreadCount)
+{
+    std::mutex ids_mtx;
+    std::set<std::thread::id> ids;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        executor_.post([&]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(ids_mtx);
+                ids.insert(std::this_thread::get_id());
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            set_done();
+        });
+    }
+    wait_done(200);
+
+    /* However many tasks are posted, they share the executor threads. */
+    std::lock_guard<std::mutex> lock(ids_mtx);
+    ASSERT_LE(ids.size(), 2u);
+}
+
+TEST_F(DeliveryExecutorTest, Destruction)
+{
+    std::atomic<size_t> counter{0};
+    {
+        DeliveryExecutor executor(1);
+        executor.post_at(std::chrono::steady_clock::now() + std::chrono::hours(1), [&]() { ++counter; });
+    }
+
+    /* Pending timed tasks do not delay the destruction, nor run. */
+    ASSERT_EQ(0u, counter.load());
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
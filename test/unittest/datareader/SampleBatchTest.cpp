@@ -0,0 +1,235 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/datareader/SampleBatch.hpp>
+
+#include <fastcdr/Cdr.h>
+#include <fastcdr/FastBuffer.h>
+
+#include <gtest/gtest.h>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class SampleBatchTest : public ::testing::Test
+{
+protected:
+    SampleBatchTest()
+        : samples_{{0x01}, {0x02, 0x03, 0x04, 0x05, 0x06}, {}, {0x07, 0x08}}
+    {}
+
+    void append_samples(SampleBatch& batch)
+    {
+        for (size_t i = 0; i < samples_.size(); ++i)
+        {
+            ASSERT_TRUE(batch.fits(samples_[i].size()));
+            batch.append(samples_[i], uint32_t(10 + i), uint32_t(1000 + 100 * i));
+        }
+        ASSERT_EQ(samples_.size(), batch.get_count());
+    }
+
+    std::vector<std::vector<uint8_t>> samples_;
+};
+
+TEST_F(SampleBatchTest, DataSeq)
+{
+    SampleBatch batch(dds::xrce::FORMAT_DATA_SEQ, 512);
+    append_samples(batch);
+    std::vector<uint8_t> payload = batch.release();
+
+    fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(payload.data()), payload.size());
+    fastcdr::Cdr deserializer(fastbuffer, fastcdr::Cdr::LITTLE_ENDIANNESS);
+    uint32_t count;
+    deserializer >> count;
+    ASSERT_EQ(samples_.size(), count);
+    for (const auto& sample : samples_)
+    {
+        std::vector<uint8_t> data;
+        deserializer >> data;
+        ASSERT_EQ(sample, data);
+    }
+    ASSERT_EQ(payload.size(), deserializer.getSerializedDataLength());
+}
+
+TEST_F(SampleBatchTest, SampleSeq)
+{
+    SampleBatch batch(dds::xrce::FORMAT_SAMPLE_SEQ, 512);
+    append_samples(batch);
+    std::vector<uint8_t> payload = batch.release();
+
+    fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(payload.data()), payload.size());
+    fastcdr::Cdr deserializer(fastbuffer, fastcdr::Cdr::LITTLE_ENDIANNESS);
+    uint32_t count;
+    deserializer >> count;
+    ASSERT_EQ(samples_.size(), count);
+    for (size_t i = 0; i < samples_.size(); ++i)
+    {
+        dds::xrce::SampleInfo info;
+        std::vector<uint8_t> data;
+        deserializer >> info >> data;
+        ASSERT_EQ(10 + i, info.sequence_number());
+        ASSERT_EQ(1000 + 100 * i, info.session_time_offset());
+        ASSERT_EQ(samples_[i], data);
+    }
+    ASSERT_EQ(payload.size(), deserializer.getSerializedDataLength());
+}
+
+TEST_F(SampleBatchTest, PackedSamples)
+{
+    SampleBatch batch(dds::xrce::FORMAT_PACKED_SAMPLES, 512);
+    append_samples(batch);
+    std::vector<uint8_t> payload = batch.release();
+
+    fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(payload.data()), payload.size());
+    fastcdr::Cdr deserializer(fastbuffer, fastcdr::Cdr::LITTLE_ENDIANNESS);
+    dds::xrce::SampleInfo info_base;
+    uint32_t count;
+    deserializer >> info_base >> count;
+    ASSERT_EQ(10u, info_base.sequence_number());
+    ASSERT_EQ(1000u, info_base.session_time_offset());
+    ASSERT_EQ(samples_.size(), count);
+    for (size_t i = 0; i < samples_.size(); ++i)
+    {
+        dds::xrce::SampleInfoDelta info_delta;
+        std::vector<uint8_t> data;
+        deserializer >> info_delta >> data;
+        ASSERT_EQ(i, info_delta.seq_number_delta());
+        ASSERT_EQ(i, info_delta.timestamp_delta());
+        ASSERT_EQ(samples_[i], data);
+    }
+    ASSERT_EQ(payload.size(), deserializer.getSerializedDataLength());
+}
+
+TEST_F(SampleBatchTest, SingleSample)
+{
+    /* The data of a single sample runs to the end of the payload. */
+    SampleBatch batch(dds::xrce::FORMAT_SAMPLE, 512);
+    ASSERT_TRUE(batch.fits(samples_[1].size()));
+    batch.append(samples_[1], 7, 300);
+    ASSERT_FALSE(batch.fits(samples_[0].size()));
+    std::vector<uint8_t> payload = batch.release();
+
+    fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(payload.data()), payload.size());
+    fastcdr::Cdr deserializer(fastbuffer, fastcdr::Cdr::LITTLE_ENDIANNESS);
+    dds::xrce::SampleInfo info;
+    deserializer >> info;
+    ASSERT_EQ(7u, info.sequence_number());
+    ASSERT_EQ(300u, info.session_time_offset());
+    ASSERT_EQ(samples_[1], std::vector<uint8_t>(payload.begin() + int(deserializer.getSerializedDataLength()),
+                                                 payload.end()));
+}
+
+TEST_F(SampleBatchTest, MaxSize)
+{
+    /* Count and length plus data, the first sample is taken even if it is larger. */
+    const std::vector<uint8_t> sample(20, 0xAA);
+    SampleBatch batch(dds::xrce::FORMAT_DATA_SEQ, 64);
+    ASSERT_TRUE(batch.fits(100));
+    batch.append(sample, 0, 0);
+    ASSERT_EQ(28u, batch.get_size());
+    ASSERT_TRUE(batch.fits(sample.size()));
+    batch.append(sample, 1, 0);
+    ASSERT_EQ(52u, batch.get_size());
+    ASSERT_TRUE(batch.fits(8));
+    ASSERT_FALSE(batch.fits(9));
+
+    ASSERT_EQ(52u, batch.release().size());
+    ASSERT_EQ(0u, batch.get_count());
+}
+
+TEST_F(SampleBatchTest, PackedLimit)
+{
+    /* Sequence numbers are packed as an 8-bit delta. */
+    const std::vector<uint8_t> sample;
+    SampleBatch batch(dds::xrce::FORMAT_PACKED_SAMPLES, 65535);
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        ASSERT_TRUE(batch.fits(sample.size()));
+        batch.append(sample, i, 0);
+    }
+    ASSERT_FALSE(batch.fits(sample.size()));
+}
+
+TEST_F(SampleBatchTest, Deserialize)
+{
+    /* WRITE_DATA payloads share the layout of the batches, samples are split in place. */
+    const dds::xrce::DataFormat formats[] = {
+        dds::xrce::FORMAT_DATA_SEQ, dds::xrce::FORMAT_SAMPLE_SEQ, dds::xrce::FORMAT_PACKED_SAMPLES};
+    for (dds::xrce::DataFormat format : formats)
+    {
+        SampleBatch batch(format, 512);
+        append_samples(batch);
+        std::vector<uint8_t> payload = batch.release();
+
+        std::vector<ByteView> samples;
+        ASSERT_TRUE(SampleBatch::deserialize(format, payload, true, samples));
+        ASSERT_EQ(samples_.size(), samples.size());
+        for (size_t i = 0; i < samples_.size(); ++i)
+        {
+            ASSERT_EQ(samples_[i], samples[i].to_vector());
+            ASSERT_TRUE(payload.data() <= samples[i].data());
+            ASSERT_TRUE(samples[i].end() <= payload.data() + payload.size());
+        }
+    }
+
+    SampleBatch batch(dds::xrce::FORMAT_SAMPLE, 512);
+    batch.append(samples_[1], 7, 300);
+    std::vector<uint8_t> payload = batch.release();
+    std::vector<ByteView> samples;
+    ASSERT_TRUE(SampleBatch::deserialize(dds::xrce::FORMAT_SAMPLE, payload, true, samples));
+    ASSERT_EQ(1u, samples.size());
+    ASSERT_EQ(samples_[1], samples[0].to_vector());
+
+    samples.clear();
+    ASSERT_FALSE(SampleBatch::deserialize(0x04, payload, true, samples));
+}
+
+TEST_F(SampleBatchTest, DeserializeTruncated)
+{
+    SampleBatch batch(dds::xrce::FORMAT_DATA_SEQ, 512);
+    append_samples(batch);
+    std::vector<uint8_t> payload = batch.release();
+
+    /* The last sample is cut, the previous ones are kept. */
+    payload.pop_back();
+    std::vector<ByteView> samples;
+    ASSERT_FALSE(SampleBatch::deserialize(dds::xrce::FORMAT_DATA_SEQ, payload, true, samples));
+    ASSERT_EQ(samples_.size() - 1, samples.size());
+
+    /* A length beyond the payload. */
+    std::vector<uint8_t> oversized{0x01, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+    samples.clear();
+    ASSERT_FALSE(SampleBatch::deserialize(dds::xrce::FORMAT_DATA_SEQ, oversized, true, samples));
+    ASSERT_TRUE(samples.empty());
+
+    /* Missing samples. */
+    std::vector<uint8_t> missing{0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xAA};
+    ASSERT_FALSE(SampleBatch::deserialize(dds::xrce::FORMAT_DATA_SEQ, missing, true, samples));
+    ASSERT_EQ(1u, samples.size());
+}
+
+TEST_F(SampleBatchTest, ValidFormats)
+{
+    ASSERT_TRUE(SampleBatch::is_valid_format(dds::xrce::FORMAT_DATA));
+    ASSERT_TRUE(SampleBatch::is_valid_format(dds::xrce::FORMAT_SAMPLE));
+    ASSERT_TRUE(SampleBatch::is_valid_format(dds::xrce::FORMAT_DATA_SEQ));
+    ASSERT_TRUE(SampleBatch::is_valid_format(dds::xrce::FORMAT_SAMPLE_SEQ));
+    ASSERT_TRUE(SampleBatch::is_valid_format(dds::xrce::FORMAT_PACKED_SAMPLES));
+    ASSERT_FALSE(SampleBatch::is_valid_format(0x04));
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
@@ -0,0 +1,147 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/message/BufferPool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class BufferPoolTest : public ::testing::Test
+{
+protected:
+    BufferPoolTest()
+        : pool_(64, 4)
+    {}
+
+    BufferPool pool_;
+};
+
+TEST_F(BufferPoolTest, AcquireRelease)
+{
+    uint8_t* data;
+    {
+        PooledBuffer buffer = pool_.acquire();
+        ASSERT_NE(nullptr, buffer.get());
+        ASSERT_EQ(64u, buffer.size());
+        ASSERT_TRUE(buffer.is_pooled());
+        data = buffer.get();
+    }
+
+    /* The released buffer is handed out again. */
+    PooledBuffer buffer = pool_.acquire();
+    ASSERT_EQ(data, buffer.get());
+}
+
+TEST_F(BufferPoolTest, Move)
+{
+    PooledBuffer buffer = pool_.acquire();
+    uint8_t* data = buffer.get();
+
+    PooledBuffer moved(std::move(buffer));
+    ASSERT_EQ(nullptr, buffer.get());
+    ASSERT_EQ(data, moved.get());
+
+    buffer = std::move(moved);
+    ASSERT_EQ(nullptr, moved.get());
+    ASSERT_EQ(data, buffer.get());
+}
+
+TEST_F(BufferPoolTest, HeapBuffer)
+{
+    PooledBuffer buffer(128);
+    ASSERT_NE(nullptr, buffer.get());
+    ASSERT_EQ(128u, buffer.size());
+    ASSERT_FALSE(buffer.is_pooled());
+}
+
+TEST_F(BufferPoolTest, Overflow)
+{
+    /* Acquiring more buffers than the pool caches allocates, releasing them deletes the excess. */
+    std::vector<PooledBuffer> buffers;
+    std::set<uint8_t*> addresses;
+    for (int i = 0; i < 8; ++i)
+    {
+        buffers.push_back(pool_.acquire());
+        addresses.insert(buffers.back().get());
+    }
+    ASSERT_EQ(8u, addresses.size());
+    buffers.clear();
+
+    for (int i = 0; i < 8; ++i)
+    {
+        buffers.push_back(pool_.acquire());
+        ASSERT_NE(nullptr, buffers.back().get());
+    }
+}
+
+TEST_F(BufferPoolTest, Concurrent)
+{
+    const int iterations = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([this, iterations, t]()
+        {
+            for (int i = 0; i < iterations; ++i)
+            {
+                PooledBuffer buffer = pool_.acquire();
+                buffer.get()[0] = uint8_t(t);
+                buffer.get()[buffer.size() - 1] = uint8_t(t);
+                ASSERT_EQ(uint8_t(t), buffer.get()[0]);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+TEST(SampleBufferPoolTest, AcquireRelease)
+{
+    SampleBufferPool pool(64, 4);
+    const uint8_t* data;
+    {
+        std::shared_ptr<std::vector<uint8_t>> buffer = pool.acquire();
+        ASSERT_TRUE(buffer->empty());
+        buffer->assign(32, 0xAA);
+        data = buffer->data();
+    }
+
+    /* The released vector is handed out again, empty but keeping its storage. */
+    std::shared_ptr<std::vector<uint8_t>> buffer = pool.acquire();
+    ASSERT_TRUE(buffer->empty());
+    ASSERT_LE(32u, buffer->capacity());
+    buffer->resize(32);
+    ASSERT_EQ(data, buffer->data());
+}
+
+TEST(SampleBufferPoolTest, MaxCapacity)
+{
+    /* Vectors grown beyond the limit are deleted, so large samples do not stay cached. */
+    SampleBufferPool pool(64, 4);
+    pool.acquire()->resize(128);
+    ASSERT_EQ(0u, pool.acquire()->capacity());
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
@@ -915,6 +915,139 @@ TEST_F(CedMiddlewareUnitTests, WriteReadData)
     EXPECT_FALSE(middleware_.read_data(1, input_data, std::chrono::milliseconds(100)));
 }
 
+TEST_F(CedMiddlewareUnitTests, WriteReadDataBatch)
+{
+    std::string participant_ref{"Participant"};
+    middleware_.create_participant_by_ref(0, 0, participant_ref);
+
+    std::string topic_ref{"Topic"};
+    middleware_.create_topic_by_ref(0, 0, topic_ref);
+
+    std::string subscriber_xml{"Subscriber"};
+    middleware_.create_subscriber_by_xml(0, 0, subscriber_xml);
+
+    std::string publisher_xml{"Publisher"};
+    middleware_.create_publisher_by_xml(0, 0, publisher_xml);
+
+    uint16_t associated_topic;
+
+    std::string datareader_ref{"Topic"};
+    middleware_.create_datareader_by_ref(0, 0, datareader_ref, associated_topic);
+
+    std::string datawriter_ref{"Topic"};
+    middleware_.create_datawriter_by_ref(0, 0, datawriter_ref, associated_topic);
+
+    std::vector<std::vector<uint8_t>> output_data_list{{0, 1, 2}, {3, 4, 5}, {6}};
+    std::vector<ByteView> output_batch(output_data_list.begin(), output_data_list.end());
+    std::vector<uint8_t> input_data{};
+    size_t notifications = 0;
+
+    /* Write on unknown DataWriter. */
+    EXPECT_FALSE(middleware_.write_data_batch(1, output_batch));
+
+    /* The batch notifies the DataReader once and is read in order. */
+    EXPECT_TRUE(middleware_.set_on_data_available(0, [&]() { ++notifications; }));
+    EXPECT_TRUE(middleware_.write_data_batch(0, output_batch));
+    EXPECT_EQ(notifications, 1u);
+    for (const auto& output_data : output_data_list)
+    {
+        EXPECT_TRUE(middleware_.read_data(0, input_data, std::chrono::milliseconds(0)));
+        EXPECT_EQ(output_data, input_data);
+    }
+    EXPECT_FALSE(middleware_.read_data(0, input_data, std::chrono::milliseconds(0)));
+}
+
+TEST_F(CedMiddlewareUnitTests, LoanData)
+{
+    std::string participant_ref{"Participant"};
+    middleware_.create_participant_by_ref(0, 0, participant_ref);
+
+    std::string topic_ref{"Topic"};
+    middleware_.create_topic_by_ref(0, 0, topic_ref);
+
+    std::string subscriber_xml{"Subscriber"};
+    middleware_.create_subscriber_by_xml(0, 0, subscriber_xml);
+
+    std::string publisher_xml{"Publisher"};
+    middleware_.create_publisher_by_xml(0, 0, publisher_xml);
+
+    uint16_t associated_topic;
+
+    std::string datareader_ref{"Topic"};
+    middleware_.create_datareader_by_ref(0, 0, datareader_ref, associated_topic);
+
+    std::string datawriter_ref{"Topic"};
+    middleware_.create_datawriter_by_ref(0, 0, datawriter_ref, associated_topic);
+
+    std::vector<uint8_t> output_data_one{0, 1, 2};
+    std::vector<uint8_t> output_data_two{3, 4, 5, 6};
+    std::vector<uint8_t> input_data{};
+    auto on_loan = [&](const ByteView& sample) { input_data.assign(sample.begin(), sample.end()); };
+
+    /* Loan on unknown DataReader. */
+    EXPECT_FALSE(middleware_.loan_data(1, on_loan));
+
+    /* Loan without data, it does not block. */
+    EXPECT_FALSE(middleware_.loan_data(0, on_loan));
+
+    /* The samples are lent in order. */
+    EXPECT_TRUE(middleware_.write_data(0, output_data_one));
+    EXPECT_TRUE(middleware_.write_data(0, output_data_two));
+    EXPECT_TRUE(middleware_.loan_data(0, on_loan));
+    EXPECT_EQ(output_data_one, input_data);
+    EXPECT_TRUE(middleware_.loan_data(0, on_loan));
+    EXPECT_EQ(output_data_two, input_data);
+    EXPECT_FALSE(middleware_.loan_data(0, on_loan));
+}
+
+TEST_F(CedMiddlewareUnitTests, OnDataAvailable)
+{
+    std::string participant_ref{"Participant"};
+    middleware_.create_participant_by_ref(0, 0, participant_ref);
+
+    std::string topic_ref{"Topic"};
+    middleware_.create_topic_by_ref(0, 0, topic_ref);
+
+    std::string subscriber_xml{"Subscriber"};
+    middleware_.create_subscriber_by_xml(0, 0, subscriber_xml);
+
+    std::string publisher_xml{"Publisher"};
+    middleware_.create_publisher_by_xml(0, 0, publisher_xml);
+
+    uint16_t associated_topic;
+
+    std::string datareader_ref{"Topic"};
+    middleware_.create_datareader_by_ref(0, 0, datareader_ref, associated_topic);
+
+    std::string datawriter_ref{"Topic"};
+    middleware_.create_datawriter_by_ref(0, 0, datawriter_ref, associated_topic);
+
+    std::vector<uint8_t> output_data{0, 1, 2};
+    std::vector<uint8_t> input_data{};
+    size_t notifications = 0;
+
+    /* Set callback on unknown DataReader. */
+    EXPECT_FALSE(middleware_.set_on_data_available(1, [&]() { ++notifications; }));
+
+    /* Each write notifies the DataReader, which reads without waiting. */
+    EXPECT_TRUE(middleware_.set_on_data_available(0, [&]() { ++notifications; }));
+    EXPECT_TRUE(middleware_.write_data(0, output_data));
+    EXPECT_EQ(notifications, 1u);
+    EXPECT_TRUE(middleware_.read_data(0, input_data, std::chrono::milliseconds(0)));
+    EXPECT_TRUE(std::equal(output_data.begin(), output_data.end(), input_data.begin()));
+
+    /* Removed callback. */
+    EXPECT_TRUE(middleware_.set_on_data_available(0, nullptr));
+    EXPECT_TRUE(middleware_.write_data(0, output_data));
+    EXPECT_EQ(notifications, 1u);
+
+    /* Deleted DataReader. */
+    EXPECT_TRUE(middleware_.set_on_data_available(0, [&]() { ++notifications; }));
+    EXPECT_TRUE(middleware_.delete_datareader(0));
+    EXPECT_TRUE(middleware_.write_data(0, output_data));
+    EXPECT_EQ(notifications, 1u);
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace testing
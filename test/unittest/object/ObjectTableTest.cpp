@@ -0,0 +1,90 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/object/ObjectTable.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class ObjectTableTest : public ::testing::Test
+{
+protected:
+    ObjectTable<int> table_;
+};
+
+TEST_F(ObjectTableTest, SetGet)
+{
+    ASSERT_FALSE(table_.get(0x000));
+    ASSERT_FALSE(table_.get(0xFFF));
+
+    std::shared_ptr<int> first = std::make_shared<int>(1);
+    std::shared_ptr<int> last = std::make_shared<int>(2);
+    table_.set(0x000, first);
+    table_.set(0xFFF, last);
+    ASSERT_EQ(first, table_.get(0x000));
+    ASSERT_EQ(last, table_.get(0xFFF));
+    ASSERT_FALSE(table_.get(0x001));
+
+    /* Only the 12 bits of the raw id are taken. */
+    ASSERT_EQ(first, table_.get(0x1000));
+
+    table_.set(0x000, nullptr);
+    ASSERT_FALSE(table_.get(0x000));
+    ASSERT_EQ(last, table_.get(0xFFF));
+}
+
+TEST_F(ObjectTableTest, RemoveIf)
+{
+    for (uint16_t i = 0; i < 200; ++i)
+    {
+        table_.set(i, std::make_shared<int>(i));
+    }
+    table_.remove_if([](uint16_t raw_id) { return 0 == (raw_id % 2); });
+    for (uint16_t i = 0; i < 200; ++i)
+    {
+        ASSERT_EQ(0 != (i % 2), bool(table_.get(i)));
+    }
+}
+
+TEST_F(ObjectTableTest, ConcurrentGet)
+{
+    /* Lookups keep the object alive while it is replaced or cleared. */
+    std::atomic<bool> running{true};
+    std::thread reader([&]()
+    {
+        while (running)
+        {
+            if (std::shared_ptr<int> object = table_.get(0x123))
+            {
+                ASSERT_EQ(7, *object);
+            }
+        }
+    });
+    for (int i = 0; i < 10000; ++i)
+    {
+        table_.set(0x123, std::make_shared<int>(7));
+        table_.set(0x123, nullptr);
+    }
+    running = false;
+    reader.join();
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
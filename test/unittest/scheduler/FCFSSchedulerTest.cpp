@@ -0,0 +1,135 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class FCFSSchedulerTest : public ::testing::Test
+{
+protected:
+    FCFSSchedulerTest()
+        : scheduler_(4)
+    {}
+
+    ~FCFSSchedulerTest() override
+    {
+        scheduler_.deinit();
+    }
+
+    void fill(int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            scheduler_.push(int(i), 0);
+        }
+    }
+
+    std::vector<int> drain()
+    {
+        std::vector<int> elements;
+        scheduler_.pop_batch(elements, 16);
+        return elements;
+    }
+
+    FCFSScheduler<int> scheduler_;
+};
+
+TEST_F(FCFSSchedulerTest, DropOldest)
+{
+    scheduler_.set_overflow_policy(OverflowPolicy::DROP_OLDEST, std::chrono::milliseconds(0));
+    scheduler_.init();
+    fill(6);
+    ASSERT_EQ(2u, scheduler_.get_dropped());
+    ASSERT_EQ(std::vector<int>({2, 3, 4, 5}), drain());
+}
+
+TEST_F(FCFSSchedulerTest, DropNewest)
+{
+    scheduler_.set_overflow_policy(OverflowPolicy::DROP_NEWEST, std::chrono::milliseconds(0));
+    scheduler_.init();
+    fill(6);
+    ASSERT_EQ(2u, scheduler_.get_dropped());
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), drain());
+}
+
+TEST_F(FCFSSchedulerTest, BlockTimeout)
+{
+    scheduler_.set_overflow_policy(OverflowPolicy::BLOCK, std::chrono::milliseconds(20));
+    scheduler_.init();
+    fill(4);
+
+    auto start = std::chrono::steady_clock::now();
+    scheduler_.push(4, 0);
+    ASSERT_LE(std::chrono::milliseconds(20), std::chrono::steady_clock::now() - start);
+    ASSERT_EQ(1u, scheduler_.get_dropped());
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), drain());
+}
+
+TEST_F(FCFSSchedulerTest, BlockUntilPop)
+{
+    scheduler_.set_overflow_policy(OverflowPolicy::BLOCK, std::chrono::milliseconds(10000));
+    scheduler_.init();
+    fill(4);
+
+    std::thread producer([&]()
+    {
+        scheduler_.push(4, 0);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    int element;
+    ASSERT_TRUE(scheduler_.pop(element));
+    ASSERT_EQ(0, element);
+    producer.join();
+
+    ASSERT_EQ(0u, scheduler_.get_dropped());
+    ASSERT_EQ(std::vector<int>({1, 2, 3, 4}), drain());
+}
+
+TEST_F(FCFSSchedulerTest, BlockedBatchWakesUpConsumer)
+{
+    scheduler_.set_overflow_policy(OverflowPolicy::BLOCK, std::chrono::milliseconds(1000));
+    scheduler_.init();
+
+    std::vector<int> received;
+    std::thread consumer([&]()
+    {
+        int element;
+        while (scheduler_.pop(element) && (0 <= element))
+        {
+            received.push_back(element);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::vector<int> elements{0, 1, 2, 3, 4, 5, 6, 7};
+    scheduler_.push_batch(elements, 0);
+    scheduler_.push(-1, 0);
+    consumer.join();
+
+    ASSERT_EQ(0u, scheduler_.get_dropped());
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}), received);
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
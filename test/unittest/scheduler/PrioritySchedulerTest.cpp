@@ -0,0 +1,97 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/scheduler/PriorityScheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class PrioritySchedulerTest : public ::testing::Test
+{
+protected:
+    PrioritySchedulerTest()
+        : scheduler_(4, 2)
+    {
+        scheduler_.init();
+    }
+
+    ~PrioritySchedulerTest() override
+    {
+        scheduler_.deinit();
+    }
+
+    PriorityScheduler<int> scheduler_;
+};
+
+TEST_F(PrioritySchedulerTest, HigherPriorityFirst)
+{
+    scheduler_.push(10, 1);
+    scheduler_.push(11, 1);
+    scheduler_.push(0, 0);
+
+    int element;
+    ASSERT_TRUE(scheduler_.pop(element));
+    ASSERT_EQ(0, element);
+    ASSERT_TRUE(scheduler_.pop(element));
+    ASSERT_EQ(10, element);
+    ASSERT_TRUE(scheduler_.pop(element));
+    ASSERT_EQ(11, element);
+}
+
+TEST_F(PrioritySchedulerTest, UnknownPriorityGoesToLowestLane)
+{
+    scheduler_.push(20, 7);
+    scheduler_.push(0, 0);
+
+    int element;
+    ASSERT_TRUE(scheduler_.pop(element));
+    ASSERT_EQ(0, element);
+    ASSERT_TRUE(scheduler_.pop(element));
+    ASSERT_EQ(20, element);
+}
+
+TEST_F(PrioritySchedulerTest, DropLowestPriorityWhenFull)
+{
+    scheduler_.push(0, 0);
+    scheduler_.push(10, 1);
+    scheduler_.push(11, 1);
+    scheduler_.push(1, 0);
+    scheduler_.push(2, 0);
+
+    std::vector<int> elements;
+    ASSERT_TRUE(scheduler_.pop_batch(elements, 8));
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 11}), elements);
+}
+
+TEST_F(PrioritySchedulerTest, DeinitWakesUpConsumer)
+{
+    std::thread consumer([&]()
+    {
+        int element;
+        ASSERT_FALSE(scheduler_.pop(element));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    scheduler_.deinit();
+    consumer.join();
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
@@ -0,0 +1,208 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/scheduler/RingScheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+class RingSchedulerTest : public ::testing::Test
+{
+protected:
+    RingSchedulerTest()
+        : scheduler_(8)
+    {
+        scheduler_.init();
+    }
+
+    ~RingSchedulerTest() override
+    {
+        scheduler_.deinit();
+    }
+
+    RingScheduler<int> scheduler_;
+};
+
+TEST_F(RingSchedulerTest, PushPopOrder)
+{
+    for (int i = 0; i < 5; ++i)
+    {
+        scheduler_.push(int(i), 0);
+    }
+
+    int element;
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_TRUE(scheduler_.pop(element));
+        ASSERT_EQ(i, element);
+    }
+}
+
+TEST_F(RingSchedulerTest, DropOldestWhenFull)
+{
+    ASSERT_EQ(8u, scheduler_.capacity());
+    for (int i = 0; i < 10; ++i)
+    {
+        scheduler_.push(int(i), 0);
+    }
+
+    int element;
+    for (int i = 2; i < 10; ++i)
+    {
+        ASSERT_TRUE(scheduler_.pop(element));
+        ASSERT_EQ(i, element);
+    }
+}
+
+TEST(RingSchedulerOverflowTest, DropNewest)
+{
+    RingScheduler<int> scheduler(4);
+    scheduler.set_overflow_policy(OverflowPolicy::DROP_NEWEST, std::chrono::milliseconds(0));
+    scheduler.init();
+    for (int i = 0; i < 6; ++i)
+    {
+        scheduler.push(int(i), 0);
+    }
+    ASSERT_EQ(2u, scheduler.get_dropped());
+
+    std::vector<int> elements;
+    ASSERT_TRUE(scheduler.pop_batch(elements, 8));
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), elements);
+    scheduler.deinit();
+}
+
+TEST(RingSchedulerOverflowTest, BlockUntilPop)
+{
+    RingScheduler<int> scheduler(2);
+    scheduler.set_overflow_policy(OverflowPolicy::BLOCK, std::chrono::milliseconds(10000));
+    scheduler.init();
+    scheduler.push(0, 0);
+    scheduler.push(1, 0);
+
+    std::thread producer([&]()
+    {
+        scheduler.push(2, 0);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    int element;
+    ASSERT_TRUE(scheduler.pop(element));
+    ASSERT_EQ(0, element);
+    producer.join();
+
+    std::vector<int> elements;
+    ASSERT_TRUE(scheduler.pop_batch(elements, 8));
+    ASSERT_EQ(std::vector<int>({1, 2}), elements);
+    ASSERT_EQ(0u, scheduler.get_dropped());
+    scheduler.deinit();
+}
+
+TEST(RingSchedulerOverflowTest, BlockedBatchWakesUpConsumer)
+{
+    RingScheduler<int> scheduler(2);
+    scheduler.set_overflow_policy(OverflowPolicy::BLOCK, std::chrono::milliseconds(1000));
+    scheduler.init();
+
+    std::vector<int> received;
+    std::thread consumer([&]()
+    {
+        int element;
+        while (scheduler.pop(element) && (0 <= element))
+        {
+            received.push_back(element);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::vector<int> elements{0, 1, 2, 3, 4, 5, 6, 7};
+    scheduler.push_batch(elements, 0);
+    scheduler.push(-1, 0);
+    consumer.join();
+
+    ASSERT_EQ(0u, scheduler.get_dropped());
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}), received);
+    scheduler.deinit();
+}
+
+TEST_F(RingSchedulerTest, Batches)
+{
+    std::vector<int> elements{0, 1, 2, 3, 4, 5};
+    scheduler_.push_batch(elements, 0);
+    ASSERT_TRUE(elements.empty());
+
+    ASSERT_TRUE(scheduler_.pop_batch(elements, 4));
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), elements);
+    elements.clear();
+    ASSERT_TRUE(scheduler_.pop_batch(elements, 4));
+    ASSERT_EQ(std::vector<int>({4, 5}), elements);
+}
+
+TEST_F(RingSchedulerTest, DeinitWakesUpConsumer)
+{
+    std::thread consumer([&]()
+    {
+        int element;
+        ASSERT_FALSE(scheduler_.pop(element));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    scheduler_.deinit();
+    consumer.join();
+}
+
+TEST(RingSchedulerConcurrencyTest, MultipleProducers)
+{
+    const int producers_count = 4;
+    const int elements_per_producer = 20000;
+    RingScheduler<int> scheduler(producers_count * elements_per_producer);
+    scheduler.init();
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producers_count; ++p)
+    {
+        producers.emplace_back([&scheduler, p, elements_per_producer]()
+        {
+            for (int i = 0; i < elements_per_producer; ++i)
+            {
+                scheduler.push(int((p * elements_per_producer) + i), 0);
+            }
+        });
+    }
+
+    /* Every element is received and each producer keeps its ordering. */
+    std::vector<int> last(producers_count, -1);
+    int element;
+    for (int i = 0; i < producers_count * elements_per_producer; ++i)
+    {
+        ASSERT_TRUE(scheduler.pop(element));
+        size_t producer = size_t(element / elements_per_producer);
+        ASSERT_LT(last[producer], element);
+        last[producer] = element;
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    scheduler.deinit();
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
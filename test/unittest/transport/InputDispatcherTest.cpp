@@ -0,0 +1,177 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/transport/InputDispatcher.hpp>
+#include <uxr/agent/transport/endpoint/IPv4EndPoint.hpp>
+#include <uxr/agent/scheduler/FCFSScheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+constexpr size_t worker_count = 4;
+constexpr size_t client_count = 16;
+constexpr uint16_t message_count = 64;
+
+class InputDispatcherTest : public ::testing::Test
+{
+protected:
+    InputDispatcherTest()
+        : worker_queues_()
+        , sources_()
+    {
+        for (size_t i = 0; i < worker_count; ++i)
+        {
+            worker_queues_.emplace_back(new FCFSScheduler<InputPacket>(client_count * message_count + 1));
+            worker_queues_.back()->init();
+        }
+        for (size_t i = 0; i < client_count; ++i)
+        {
+            sources_.emplace_back(new IPv4EndPoint(0x0100007F, uint16_t(7000 + i)));
+        }
+    }
+
+    ~InputDispatcherTest() override
+    {
+        for (auto& worker_queue : worker_queues_)
+        {
+            worker_queue->deinit();
+        }
+    }
+
+    /* Even clients carry their key, odd ones are told by their source. */
+    InputPacket generate_packet(
+            size_t client,
+            uint16_t sequence_nr)
+    {
+        dds::xrce::MessageHeader header;
+        header.session_id((0 == client % 2) ? 0x01 : 0x81);
+        header.stream_id(0x01);
+        header.sequence_nr(sequence_nr);
+        header.client_key(conversion::raw_to_clientkey(uint32_t(0xAABB0000 + client)));
+
+        uint8_t buf[16];
+        fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(buf), sizeof(buf));
+        fastcdr::Cdr serializer(fastbuffer);
+        header.serialize(serializer);
+
+        InputPacket input_packet;
+        input_packet.source = sources_[client];
+        input_packet.message.reset(new InputMessage(buf, serializer.getSerializedDataLength()));
+        return input_packet;
+    }
+
+    size_t get_client(const InputPacket& input_packet)
+    {
+        const dds::xrce::MessageHeader& header = input_packet.message->get_header();
+        return (128 > header.session_id())
+               ? size_t(conversion::clientkey_to_raw(header.client_key()) - 0xAABB0000)
+               : size_t(static_cast<IPv4EndPoint*>(input_packet.source.get())->get_port() - 7000);
+    }
+
+    /* Pops every packet queued to a worker, an empty packet marks the end of the queue. */
+    std::vector<InputPacket> drain(size_t worker_id)
+    {
+        worker_queues_[worker_id]->push(InputPacket(), 0);
+        std::vector<InputPacket> input_packets;
+        InputPacket input_packet;
+        while (worker_queues_[worker_id]->pop(input_packet) && input_packet.message)
+        {
+            input_packets.push_back(std::move(input_packet));
+        }
+        return input_packets;
+    }
+
+    WorkerQueues worker_queues_;
+    std::vector<std::shared_ptr<EndPoint>> sources_;
+};
+
+/**
+ * @brief   This test checks that the packets of a client, whether pushed one by one or in batches,
+ *          always reach the same worker and keep their ordering.
+ */
+TEST_F(InputDispatcherTest, ClientAffinity)
+{
+    InputDispatcher input_dispatcher(worker_queues_);
+    std::vector<InputPacket> input_packets;
+    for (uint16_t sequence_nr = 0; sequence_nr < message_count; ++sequence_nr)
+    {
+        for (size_t client = 0; client < client_count; ++client)
+        {
+            if (0 == sequence_nr % 3)
+            {
+                input_dispatcher.push(generate_packet(client, sequence_nr));
+            }
+            else
+            {
+                input_packets.push_back(generate_packet(client, sequence_nr));
+            }
+        }
+        input_dispatcher.push_batch(input_packets);
+        ASSERT_TRUE(input_packets.empty());
+    }
+
+    std::map<size_t, size_t> client_workers;
+    std::map<size_t, uint16_t> next_sequence_nrs;
+    size_t received = 0;
+    for (size_t worker_id = 0; worker_id < worker_count; ++worker_id)
+    {
+        for (const auto& input_packet : drain(worker_id))
+        {
+            const size_t client = get_client(input_packet);
+            ASSERT_EQ(worker_id, InputDispatcher::get_worker_id(input_packet, worker_count));
+            ASSERT_EQ(worker_id, client_workers.emplace(client, worker_id).first->second);
+            ASSERT_EQ(next_sequence_nrs[client], input_packet.message->get_header().sequence_nr());
+            ++next_sequence_nrs[client];
+            ++received;
+        }
+    }
+    ASSERT_EQ(client_count * message_count, received);
+    ASSERT_EQ(client_count, client_workers.size());
+
+    /* The clients are spread over the workers. */
+    std::set<size_t> workers;
+    for (const auto& client_worker : client_workers)
+    {
+        workers.insert(client_worker.second);
+    }
+    ASSERT_LT(1u, workers.size());
+}
+
+/**
+ * @brief   This test checks that a single worker takes every packet.
+ */
+TEST_F(InputDispatcherTest, SingleWorker)
+{
+    for (size_t client = 0; client < client_count; ++client)
+    {
+        ASSERT_EQ(0u, InputDispatcher::get_worker_id(generate_packet(client, 0), 1));
+    }
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
+
+int main(int args, char** argv)
+{
+    ::testing::InitGoogleTest(&args, argv);
+    return RUN_ALL_TESTS();
+}
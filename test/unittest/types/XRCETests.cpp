@@ -266,6 +266,42 @@ TEST_F(SerializerDeserializerTests, DeleteSubmessage)
     ASSERT_EQ(delete_payload.request_id(), deserialized_data.request_id());
 }
 
+TEST_F(SerializerDeserializerTests, ScatteredDataSubmessage)
+{
+    dds::xrce::MessageHeader message_header = generate_message_header();
+    dds::xrce::BaseObjectRequest data_request;
+    data_request.request_id({0x01, 0x02});
+    data_request.object_id({0x10, 0x20});
+    ScatteredSubmessage<dds::xrce::BaseObjectRequest> data_payload{
+        data_request,
+        std::make_shared<const std::vector<uint8_t>>(std::vector<uint8_t>{0xAA, 0xBB, 0xCC, 0xDD, 0xEE})};
+    dds::xrce::SubmessageHeader submessage_header;
+    size_t message_size = message_header.getCdrSerializedSize() +
+                          submessage_header.getCdrSerializedSize() +
+                          data_payload.getCdrSerializedSize();
+
+    OutputMessage output(message_header, message_size);
+    ASSERT_TRUE(output.append_submessage(dds::xrce::DATA, data_payload));
+    ASSERT_EQ(data_payload.tail->data(), output.get_tail());
+    ASSERT_EQ(data_payload.tail->size(), output.get_tail_len());
+    ASSERT_EQ(message_size, output.get_len());
+    ASSERT_EQ(message_size - data_payload.tail->size(), output.get_head_len());
+
+    /* Nothing may follow the scattered tail. */
+    ASSERT_FALSE(output.append_raw_payload(dds::xrce::DATA, data_payload.tail->data(), 1));
+
+    dds::xrce::BaseObjectRequest deserialized_request;
+    InputMessage input(output.get_buf(), output.get_len());
+    ASSERT_TRUE(input.prepare_next_submessage());
+    ASSERT_EQ(data_payload.getCdrSerializedSize(), input.get_subheader().submessage_length());
+    ASSERT_TRUE(input.get_payload(deserialized_request));
+    ASSERT_EQ(data_request.request_id(), deserialized_request.request_id());
+    ASSERT_EQ(data_request.object_id(), deserialized_request.object_id());
+    ASSERT_EQ(0, memcmp(data_payload.tail->data(),
+                        input.get_buf() + output.get_head_len(),
+                        data_payload.tail->size()));
+}
+
 } // namespace testing
 } // namespace uxr
 } // namespace eprosima
@@ -0,0 +1,93 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/utils/RttEstimator.hpp>
+
+#include <gtest/gtest.h>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+using eprosima::uxr::utils::RttEstimator;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+class RttEstimatorTest : public ::testing::Test
+{
+protected:
+    RttEstimatorTest()
+        : estimator_(milliseconds(200), milliseconds(10), milliseconds(10000))
+    {}
+
+    RttEstimator estimator_;
+};
+
+TEST_F(RttEstimatorTest, InitialTimeout)
+{
+    ASSERT_FALSE(estimator_.has_sample());
+    ASSERT_EQ(milliseconds(200), estimator_.get_rto());
+}
+
+TEST_F(RttEstimatorTest, FirstSample)
+{
+    // RTO = R + 4 * R / 2.
+    estimator_.update(milliseconds(100));
+    ASSERT_TRUE(estimator_.has_sample());
+    ASSERT_EQ(microseconds(100000), estimator_.get_srtt());
+    ASSERT_EQ(milliseconds(300), estimator_.get_rto());
+}
+
+TEST_F(RttEstimatorTest, Convergence)
+{
+    // A stable round trip drives the variance, and the timeout, down to the round trip.
+    for (int i = 0; i < 100; ++i)
+    {
+        estimator_.update(milliseconds(500));
+    }
+    ASSERT_EQ(microseconds(500000), estimator_.get_srtt());
+    ASSERT_LE(estimator_.get_rto(), milliseconds(502));
+    ASSERT_GE(estimator_.get_rto(), milliseconds(501));
+}
+
+TEST_F(RttEstimatorTest, Bounds)
+{
+    // Fast links are limited by the minimum timeout, slow ones by the maximum.
+    estimator_.update(microseconds(150));
+    ASSERT_EQ(milliseconds(10), estimator_.get_rto());
+
+    estimator_.reset();
+    estimator_.update(milliseconds(8000));
+    ASSERT_EQ(milliseconds(10000), estimator_.get_rto());
+}
+
+TEST_F(RttEstimatorTest, BackOff)
+{
+    estimator_.update(milliseconds(100));
+    estimator_.back_off();
+    ASSERT_EQ(milliseconds(600), estimator_.get_rto());
+    for (int i = 0; i < 10; ++i)
+    {
+        estimator_.back_off();
+    }
+    ASSERT_EQ(milliseconds(10000), estimator_.get_rto());
+
+    // A new sample restores the timeout.
+    estimator_.update(milliseconds(100));
+    ASSERT_LT(estimator_.get_rto(), milliseconds(300));
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima
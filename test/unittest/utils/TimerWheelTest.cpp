@@ -0,0 +1,158 @@
+// Copyright 2019 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <uxr/agent/utils/TimerWheel.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace eprosima {
+namespace uxr {
+namespace testing {
+
+using utils::TimerWheel;
+
+class TimerWheelTest : public ::testing::Test
+{
+protected:
+    TimerWheelTest()
+        : wheel_(1000)
+    {}
+
+    std::vector<int> advance(TimerWheel::Tick now)
+    {
+        expired_.clear();
+        fired_.clear();
+        wheel_.advance(now, expired_);
+        for (auto& callback : expired_)
+        {
+            callback();
+        }
+        return fired_;
+    }
+
+    TimerWheel::TimerId schedule(TimerWheel::Tick deadline, int value)
+    {
+        return wheel_.schedule(deadline, [this, value]() { fired_.push_back(value); });
+    }
+
+    TimerWheel wheel_;
+    std::vector<TimerWheel::Callback> expired_;
+    std::vector<int> fired_;
+};
+
+TEST_F(TimerWheelTest, Expiration)
+{
+    schedule(1010, 1);
+    schedule(1005, 0);
+    schedule(1010, 2);
+    ASSERT_EQ(3u, wheel_.size());
+
+    ASSERT_TRUE(advance(1004).empty());
+    ASSERT_EQ((std::vector<int>{0}), advance(1005));
+    ASSERT_EQ((std::vector<int>{1, 2}), advance(1010));
+    ASSERT_TRUE(wheel_.empty());
+}
+
+TEST_F(TimerWheelTest, PastDeadline)
+{
+    schedule(10, 0);
+    ASSERT_TRUE(advance(1000).empty());
+    ASSERT_EQ((std::vector<int>{0}), advance(1001));
+}
+
+TEST_F(TimerWheelTest, Cancel)
+{
+    TimerWheel::TimerId first = schedule(1100, 0);
+    TimerWheel::TimerId second = schedule(1100, 1);
+    TimerWheel::TimerId third = schedule(500000, 2);
+
+    ASSERT_TRUE(wheel_.cancel(first));
+    ASSERT_FALSE(wheel_.cancel(first));
+    ASSERT_TRUE(wheel_.cancel(third));
+    ASSERT_FALSE(wheel_.cancel(TimerWheel::INVALID_TIMER + 0));
+
+    ASSERT_EQ((std::vector<int>{1}), advance(600000));
+    ASSERT_FALSE(wheel_.cancel(second));
+    ASSERT_TRUE(wheel_.empty());
+
+    /* Identifiers of released timers are not valid for the timers reusing their storage. */
+    TimerWheel::TimerId fourth = schedule(600010, 3);
+    ASSERT_FALSE(wheel_.cancel(second));
+    ASSERT_TRUE(wheel_.cancel(fourth));
+}
+
+TEST_F(TimerWheelTest, NextEvent)
+{
+    ASSERT_TRUE(TimerWheel::NEVER == wheel_.next_event());
+
+    schedule(1020, 0);
+    ASSERT_EQ(1020u, wheel_.next_event());
+
+    /* Far timers are reported at their cascade, which is never after their deadline. */
+    wheel_.cancel(schedule(1500, 1));
+    schedule(100000, 2);
+    ASSERT_EQ(1020u, wheel_.next_event());
+    advance(1020);
+    ASSERT_LE(wheel_.next_event(), 100000u);
+    ASSERT_GT(wheel_.next_event(), 1020u);
+}
+
+TEST_F(TimerWheelTest, LongDeadline)
+{
+    const TimerWheel::Tick deadline = 1000 + (TimerWheel::Tick(1) << 30);
+    schedule(deadline, 0);
+    ASSERT_TRUE(advance(deadline - 1).empty());
+    ASSERT_EQ((std::vector<int>{0}), advance(deadline));
+}
+
+TEST_F(TimerWheelTest, Random)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<TimerWheel::Tick> delay(0, 300000);
+    std::uniform_int_distribution<TimerWheel::Tick> step(0, 5000);
+
+    std::multimap<TimerWheel::Tick, int> expected;
+    TimerWheel::Tick now = 1000;
+    int value = 0;
+    for (int round = 0; round < 2000; ++round)
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            const TimerWheel::Tick deadline = now + 1 + delay(generator);
+            schedule(deadline, value);
+            expected.emplace(deadline, value++);
+        }
+
+        now += step(generator);
+        std::vector<int> fired = advance(now);
+
+        std::multiset<int> expected_fired;
+        while (!expected.empty() && (expected.begin()->first <= now))
+        {
+            expected_fired.insert(expected.begin()->second);
+            expected.erase(expected.begin());
+        }
+        ASSERT_EQ(expected_fired, std::multiset<int>(fired.begin(), fired.end()));
+        ASSERT_EQ(expected.size(), wheel_.size());
+    }
+}
+
+} // namespace testing
+} // namespace uxr
+} // namespace eprosima